@@ -30,6 +30,13 @@ namespace render
 		mat3x4,
 		mat4x3,
 		coloru32,
+		f16vec2,
+		f16vec4,
+		snorm16vec2,
+		snorm16vec4,
+		unorm16vec2,
+		unorm16vec4,
+		snorm2_10_10_10,
 		MAX
 	};
 
@@ -57,5 +64,12 @@ namespace render
 		{ DataType::mat3x4, 48 },
 		{ DataType::mat4x3, 48 },
 		{ DataType::coloru32, 4 },
+		{ DataType::f16vec2, 4 },
+		{ DataType::f16vec4, 8 },
+		{ DataType::snorm16vec2, 4 },
+		{ DataType::snorm16vec4, 8 },
+		{ DataType::unorm16vec2, 4 },
+		{ DataType::unorm16vec4, 8 },
+		{ DataType::snorm2_10_10_10, 4 },
 	};
 }
@@ -0,0 +1,145 @@
+#include "render/FileWatcher.h"
+
+#include <algorithm>
+#include <array>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace render
+{
+	void FileWatcher::watch(std::filesystem::path const& path_) {
+		auto path = normalize(path_);
+
+		if (this->files.contains(path)) {
+			return;
+		}
+
+		this->files[path] = getWriteTime(path);
+
+#ifdef __linux__
+		if (this->inotify != -1) {
+			auto directory = path.parent_path();
+
+			if (std::ranges::find(this->directories, directory, [](auto const& entry) { return entry.second; }) == this->directories.end()) {
+				auto descriptor = inotify_add_watch(this->inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+				if (descriptor != -1) {
+					this->directories[descriptor] = directory;
+				}
+			}
+		}
+#endif
+	}
+
+	bool FileWatcher::isWatched(std::filesystem::path const& path) const {
+		return this->files.contains(normalize(path));
+	}
+
+	std::vector<std::filesystem::path> FileWatcher::poll() {
+		if (this->inotify != -1) {
+			return this->pollInotify();
+		}
+
+		auto now = std::chrono::steady_clock::now();
+
+		if (now - this->lastPoll < this->pollInterval) {
+			return {};
+		}
+
+		this->lastPoll = now;
+
+		return this->pollWriteTimes();
+	}
+
+	FileWatcher::FileWatcher() {
+#ifdef __linux__
+		this->inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+	}
+
+	FileWatcher::~FileWatcher() {
+#ifdef __linux__
+		if (this->inotify != -1) {
+			close(this->inotify);
+		}
+#endif
+	}
+
+	std::filesystem::path FileWatcher::normalize(std::filesystem::path const& path) {
+		std::error_code error{};
+		auto result = std::filesystem::absolute(path, error);
+
+		if (error) {
+			return path.lexically_normal();
+		}
+
+		return result.lexically_normal();
+	}
+
+	std::optional<std::filesystem::file_time_type> FileWatcher::getWriteTime(std::filesystem::path const& path) {
+		std::error_code error{};
+		auto result = std::filesystem::last_write_time(path, error);
+
+		if (error) {
+			return std::nullopt;
+		}
+
+		return result;
+	}
+
+	std::vector<std::filesystem::path> FileWatcher::pollInotify() {
+		std::vector<std::filesystem::path> result{};
+
+#ifdef __linux__
+		alignas(inotify_event) std::array<char, 4096> buffer{};
+
+		while (true) {
+			auto size = read(this->inotify, buffer.data(), buffer.size());
+
+			if (size <= 0) {
+				break;
+			}
+
+			for (ssize_t offset = 0; offset < size;) {
+				auto event = reinterpret_cast<inotify_event const*>(buffer.data() + offset);
+				offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+				auto directory = this->directories.find(event->wd);
+
+				if (directory == this->directories.end() || event->len == 0) {
+					continue;
+				}
+
+				auto path = directory->second / event->name;
+
+				if (this->files.contains(path) && std::ranges::find(result, path) == result.end()) {
+					result.push_back(std::move(path));
+				}
+			}
+		}
+#endif
+
+		return result;
+	}
+
+	std::vector<std::filesystem::path> FileWatcher::pollWriteTimes() {
+		std::vector<std::filesystem::path> result{};
+
+		for (auto& [path, writeTime] : this->files) {
+			auto newWriteTime = getWriteTime(path);
+
+			if (newWriteTime != writeTime) {
+				writeTime = newWriteTime;
+
+				if (newWriteTime.has_value()) {
+					result.push_back(path);
+				}
+			}
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include <misc/Misc.h>
+
+namespace render
+{
+	// Reports files that were written or replaced since the last poll. Uses inotify on the parent
+	// directories on Linux, so editors that save by renaming over the file are caught as well.
+	// Elsewhere, or when inotify is unavailable, modification times are compared every pollInterval.
+	struct FileWatcher
+	{
+		std::chrono::milliseconds pollInterval{ 500 };
+
+		void watch(std::filesystem::path const& path);
+		bool isWatched(std::filesystem::path const& path) const;
+
+		std::vector<std::filesystem::path> poll();
+
+		FileWatcher();
+		~FileWatcher();
+
+		NO_COPY_MOVE(FileWatcher);
+
+	private:
+		std::map<std::filesystem::path, std::optional<std::filesystem::file_time_type>> files{};
+		std::chrono::steady_clock::time_point lastPoll{};
+
+		int inotify = -1;
+		std::map<int, std::filesystem::path> directories{};
+
+		static std::filesystem::path normalize(std::filesystem::path const& path);
+		static std::optional<std::filesystem::file_time_type> getWriteTime(std::filesystem::path const& path);
+
+		std::vector<std::filesystem::path> pollInotify();
+		std::vector<std::filesystem::path> pollWriteTimes();
+	};
+}
@@ -0,0 +1,99 @@
+#include "render/Hash.h"
+
+#include <bit>
+#include <cstring>
+
+namespace render
+{
+	namespace
+	{
+		constexpr uint64_t prime1 = 11400714785074694791ULL;
+		constexpr uint64_t prime2 = 14029467366897019727ULL;
+		constexpr uint64_t prime3 = 1609587929392839161ULL;
+		constexpr uint64_t prime4 = 9650029242287828579ULL;
+		constexpr uint64_t prime5 = 2870177450012600261ULL;
+
+		uint64_t read64(std::byte const* ptr) {
+			uint64_t result{};
+			std::memcpy(&result, ptr, sizeof(result));
+			return result;
+		}
+
+		uint32_t read32(std::byte const* ptr) {
+			uint32_t result{};
+			std::memcpy(&result, ptr, sizeof(result));
+			return result;
+		}
+
+		uint64_t round(uint64_t acc, uint64_t input) {
+			acc += input * prime2;
+			acc = std::rotl(acc, 31);
+			return acc * prime1;
+		}
+
+		uint64_t mergeRound(uint64_t acc, uint64_t value) {
+			acc ^= round(0, value);
+			return acc * prime1 + prime4;
+		}
+	}
+
+	uint64_t hashBytes(te::span<std::byte const> data, uint64_t seed) {
+		auto ptr = data.data();
+		auto end = ptr + data.size();
+
+		uint64_t h{};
+
+		if (data.size() >= 32) {
+			uint64_t v1 = seed + prime1 + prime2;
+			uint64_t v2 = seed + prime2;
+			uint64_t v3 = seed;
+			uint64_t v4 = seed - prime1;
+
+			for (; ptr + 32 <= end; ptr += 32) {
+				v1 = round(v1, read64(ptr));
+				v2 = round(v2, read64(ptr + 8));
+				v3 = round(v3, read64(ptr + 16));
+				v4 = round(v4, read64(ptr + 24));
+			}
+
+			h = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+			h = mergeRound(h, v1);
+			h = mergeRound(h, v2);
+			h = mergeRound(h, v3);
+			h = mergeRound(h, v4);
+		}
+		else {
+			h = seed + prime5;
+		}
+
+		h += static_cast<uint64_t>(data.size());
+
+		for (; ptr + 8 <= end; ptr += 8) {
+			h ^= round(0, read64(ptr));
+			h = std::rotl(h, 27) * prime1 + prime4;
+		}
+
+		if (ptr + 4 <= end) {
+			h ^= static_cast<uint64_t>(read32(ptr)) * prime1;
+			h = std::rotl(h, 23) * prime2 + prime3;
+			ptr += 4;
+		}
+
+		for (; ptr < end; ptr++) {
+			h ^= static_cast<uint64_t>(*ptr) * prime5;
+			h = std::rotl(h, 11) * prime1;
+		}
+
+		h ^= h >> 33;
+		h *= prime2;
+		h ^= h >> 29;
+		h *= prime3;
+		h ^= h >> 32;
+
+		return h;
+	}
+
+	uint64_t hashBytes(std::string_view data, uint64_t seed) {
+		return hashBytes(te::span<std::byte const>(reinterpret_cast<std::byte const*>(data.data()), data.size()), seed);
+	}
+}
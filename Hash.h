@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include <tepp/span.h>
+
+namespace render
+{
+	// XXH64, fast non-cryptographic hash for content addressing and lookup tables.
+	uint64_t hashBytes(te::span<std::byte const> data, uint64_t seed = 0);
+	uint64_t hashBytes(std::string_view data, uint64_t seed = 0);
+}
@@ -0,0 +1,42 @@
+#include "render/Parallel.h"
+
+namespace render
+{
+	integer_t getWorkerCount() {
+		return std::max(1_i, static_cast<integer_t>(std::thread::hardware_concurrency()));
+	}
+
+	void WorkerPool::submit(std::function<void()> task) {
+		{
+			std::scoped_lock lock(this->mutex);
+			this->tasks.push_back(std::move(task));
+		}
+
+		this->condition.notify_one();
+	}
+
+	WorkerPool::WorkerPool(integer_t workerCount) {
+		this->threads.reserve(std::max(1_i, workerCount));
+
+		for (integer_t i = 0; i < std::max(1_i, workerCount); i++) {
+			this->threads.emplace_back([this](std::stop_token stop) {
+				while (true) {
+					std::function<void()> task{};
+
+					{
+						std::unique_lock lock(this->mutex);
+
+						if (!this->condition.wait(lock, stop, [this] { return !this->tasks.empty(); })) {
+							return;
+						}
+
+						task = std::move(this->tasks.front());
+						this->tasks.pop_front();
+					}
+
+					task();
+				}
+			});
+		}
+	}
+}
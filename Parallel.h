@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <misc/Misc.h>
+
+#include <tepp/integers.h>
+
+namespace render
+{
+	integer_t getWorkerCount();
+
+	// Splits [0, count) into one contiguous range per worker and calls f(begin, end) for each,
+	// the calling thread handles the first range.
+	template<class F>
+	void parallelFor(integer_t count, F&& f) {
+		auto workers = std::min(getWorkerCount(), count);
+
+		if (workers <= 1) {
+			f(0_i, count);
+			return;
+		}
+
+		auto chunk = (count + workers - 1) / workers;
+
+		std::vector<std::jthread> threads{};
+		threads.reserve(workers - 1);
+
+		for (integer_t begin = chunk; begin < count; begin += chunk) {
+			auto end = std::min(count, begin + chunk);
+			threads.emplace_back([&f, begin, end]() {
+				f(begin, end);
+			});
+		}
+
+		f(0_i, std::min(count, chunk));
+	}
+
+	// Long lived worker threads running submitted tasks in submission order. Tasks still queued when
+	// the pool is destroyed are dropped.
+	struct WorkerPool
+	{
+		void submit(std::function<void()> task);
+
+		WorkerPool(integer_t workerCount = getWorkerCount());
+		~WorkerPool() = default;
+
+		NO_COPY_MOVE(WorkerPool);
+
+	private:
+		std::mutex mutex{};
+		std::condition_variable_any condition{};
+		std::deque<std::function<void()>> tasks{};
+		std::vector<std::jthread> threads{};
+	};
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 #include <misc/Misc.h>
@@ -9,18 +10,89 @@
 
 namespace render
 {
+	// Half open range of elements.
+	struct DirtyRange
+	{
+		integer_t begin{};
+		integer_t end{};
+	};
+
 	template<class T>
 	struct RenderInfoBase
 	{
 	private:
 		std::vector<T> data{};
 
+		// Elements changed through non-const access since the last clearDirty. Overlapping and adjacent
+		// ranges are merged, past maxDirtyRanges everything collapses into one covering range.
+		std::vector<DirtyRange> dirtyRanges{};
+		bool dirtyAll = false;
+
+		static constexpr integer_t maxDirtyRanges = 8;
+
 	public:
+		void markDirty(integer_t begin, integer_t end) {
+			if (this->dirtyAll || begin >= end) {
+				return;
+			}
+
+			// Stored ranges are disjoint and not adjacent, so one pass absorbs every range the new one
+			// touches, also those it only reaches after growing.
+			std::erase_if(this->dirtyRanges, [&](auto const& range) {
+				if (begin <= range.end && range.begin <= end) {
+					begin = std::min(range.begin, begin);
+					end = std::max(range.end, end);
+					return true;
+				}
+				return false;
+			});
+
+			if (isize(this->dirtyRanges) < maxDirtyRanges) {
+				this->dirtyRanges.push_back({ begin, end });
+				return;
+			}
+
+			for (auto const& range : this->dirtyRanges) {
+				begin = std::min(range.begin, begin);
+				end = std::max(range.end, end);
+			}
+
+			this->dirtyRanges.resize(1);
+			this->dirtyRanges.front() = { begin, end };
+		}
+
+		void markAllDirty() {
+			this->dirtyAll = true;
+		}
+
+		// Dirty ranges clamped to the current size.
+		te::span<DirtyRange const> getDirtyRanges() {
+			if (this->dirtyAll) {
+				this->dirtyRanges.clear();
+				this->dirtyRanges.push_back({ 0, isize(this->data) });
+				this->dirtyAll = false;
+			}
+
+			std::erase_if(this->dirtyRanges, [size = isize(this->data)](auto& range) {
+				range.end = std::min(range.end, size);
+				return range.begin >= range.end;
+			});
+
+			return this->dirtyRanges;
+		}
+
+		void clearDirty() {
+			this->dirtyRanges.clear();
+			this->dirtyAll = false;
+		}
+
 		te::span<T const> getData() const {
 			return this->data;
 		}
 
+		// The caller may change anything, all elements are marked dirty.
 		std::vector<T>& getVector() {
+			this->markAllDirty();
 			return this->data;
 		}
 
@@ -29,6 +101,7 @@ namespace render
 		}
 
 		T& get(integer_t i) {
+			this->markDirty(i, i + 1);
 			return this->data[i];
 		}
 
@@ -48,6 +121,8 @@ namespace render
 			auto d = std::max(0_i, end - begin);
 			auto everything = te::span(this->data);
 
+			this->markDirty(begin, begin + d);
+
 			return everything.subspan(begin, d);
 		}
 
@@ -68,17 +143,21 @@ namespace render
 
 		void add(T&& t) {
 			this->data.push_back(std::forward<T>(t));
+			this->markDirty(isize(this->data) - 1, isize(this->data));
 		}
 
 		void add(T const& t) {
 			this->data.push_back(t);
+			this->markDirty(isize(this->data) - 1, isize(this->data));
 		}
 
 		T& back() {
+			this->markDirty(isize(this->data) - 1, isize(this->data));
 			return this->data.back();
 		}
 
 		T& front() {
+			this->markDirty(0, 1);
 			return this->data.front();
 		}
 
@@ -87,7 +166,9 @@ namespace render
 		}
 
 		void append(RenderInfoBase<T> const& other) {
+			auto begin = isize(this->data);
 			this->data.insert(this->data.end(), other.data.begin(), other.data.end());
+			this->markDirty(begin, isize(this->data));
 		}
 
 		integer_t size() const {
@@ -100,6 +181,7 @@ namespace render
 
 		virtual void clear() {
 			this->data.clear();
+			this->clearDirty();
 		}
 
 		RenderInfoBase() = default;
@@ -13,6 +13,15 @@ constexpr float toLinear(float v) {
 	}
 }
 
+constexpr float toSRGB(float v) {
+	if (v <= 0.0031308f) {
+		return v * 12.92f;
+	}
+	else {
+		return 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+	}
+}
+
 constexpr uint8_t toLinear(uint8_t x) {
 	if (!std::is_constant_evaluated()) {
 		float const v = x / 255.0f;
@@ -0,0 +1,213 @@
+#include "render/opengl/AsyncTextureLoader.h"
+
+#include <wrangled_gl/wrangled_gl.h>
+
+#if defined(COMPILER_CLANGCL) || defined(COMPILER_CLANG)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-qualifiers"
+#pragma clang diagnostic ignored "-Wdeprecated-anon-enum-enum-conversion"
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wmissing-template-arg-list-after-template-kw"
+#elif defined(COMPILER_MSVC)
+#pragma warning(push, 0)
+#pragma warning(disable : 4201; disable : 4324; disable : 4310)
+#endif
+
+#include <gli/gli.hpp>
+
+#if defined(COMPILER_CLANGCL) || defined(COMPILER_CLANG)
+#pragma clang diagnostic pop
+#elif defined(COMPILER_MSVC)
+#pragma warning(pop)
+#endif
+
+#include <atomic>
+#include <cstring>
+#include <optional>
+#include <utility>
+
+#include "render/opengl/OpenglContext.h"
+#include "render/opengl/OpenglPBO.h"
+#include "render/opengl/Program.h"
+#include "render/opengl/TextureLoader.h"
+
+#include <tepp/nullopt.h>
+#include <tepp/safety_cast.h>
+
+namespace render::opengl
+{
+	struct impl::AsyncTextureJob
+	{
+		enum class Stage
+		{
+			PARSING,
+			PARSED,
+			STAGING,
+			STAGED,
+			DONE,
+			FAILED
+		};
+
+		std::atomic<Stage> stage = Stage::PARSING;
+
+		bool SRGB = true;
+		std::unique_ptr<DataSource> dataSource{};
+
+		std::unique_ptr<gli::texture> source{};
+		impl::UploadFormat uploadFormat{};
+
+		std::optional<OpenglPBO> pbo{};
+		te::span<std::byte> staging{};
+
+		std::optional<Opengl2DTexture> texture{};
+	};
+
+	bool AsyncTexture::ready() const {
+		return this->job != nullptr && this->job->stage == impl::AsyncTextureJob::Stage::DONE;
+	}
+
+	bool AsyncTexture::failed() const {
+		return this->job == nullptr || this->job->stage == impl::AsyncTextureJob::Stage::FAILED;
+	}
+
+	te::optional_ref<Opengl2DTexture> AsyncTexture::get() {
+		if (!this->ready()) {
+			return te::nullopt;
+		}
+
+		return this->job->texture.value();
+	}
+
+	AsyncTexture AsyncTextureLoader::load(std::unique_ptr<DataSource> dataSource, bool SRGB) {
+		using Stage = impl::AsyncTextureJob::Stage;
+
+		auto job = std::make_shared<impl::AsyncTextureJob>();
+		job->SRGB = SRGB;
+		job->dataSource = std::move(dataSource);
+
+		this->jobs.push_back(job);
+
+		this->workerPool->submit([job]() {
+			auto data = job->dataSource->data();
+			job->dataSource.reset();
+
+			if (!data.has_value()) {
+				job->stage = Stage::FAILED;
+				return;
+			}
+
+			auto buffer = data.value()->get();
+			auto Texture = gli::load(buffer.data(), buffer.size());
+
+			if (Texture.empty() || Texture.target() != gli::TARGET_2D) {
+				job->stage = Stage::FAILED;
+				return;
+			}
+
+			auto uploadFormat = impl::translateFormat(Texture, job->SRGB);
+
+			if (!uploadFormat.has_value()) {
+				job->stage = Stage::FAILED;
+				return;
+			}
+
+			job->uploadFormat = uploadFormat.value();
+			job->source = std::make_unique<gli::texture>(std::move(Texture));
+			job->stage = Stage::PARSED;
+		});
+
+		return AsyncTexture{ job };
+	}
+
+	void AsyncTextureLoader::update() {
+		using Stage = impl::AsyncTextureJob::Stage;
+
+		for (auto& job : this->jobs) {
+			switch (job->stage.load()) {
+				case Stage::PARSED:
+				{
+					auto byteSize = te::safety_cast<integer_t>(job->source->size());
+
+					if (this->stagingBytes != 0 && this->stagingBytes + byteSize > this->maxStagingBytes) {
+						break;
+					}
+
+					auto texture = impl::allocateTexture(this->openglContext, *job->source, job->uploadFormat);
+
+					if (!texture.has_value()) {
+						job->stage = Stage::FAILED;
+						break;
+					}
+
+					job->texture = std::move(std::get<Opengl2DTexture>(texture.value()));
+
+					job->pbo.emplace(this->openglContext);
+					auto staging = job->pbo->mapStaging(byteSize);
+
+					if (!staging.has_value()) {
+						this->openglContext.logError("Failed to map {} bytes of texture staging memory.\n", byteSize);
+						job->stage = Stage::FAILED;
+						break;
+					}
+
+					job->staging = staging.value();
+					this->stagingBytes += byteSize;
+					job->stage = Stage::STAGING;
+
+					this->workerPool->submit([job]() {
+						std::memcpy(job->staging.data(), job->source->data(), job->staging.size());
+						job->stage = Stage::STAGED;
+					});
+				} break;
+				case Stage::STAGED:
+				{
+					job->pbo->unmapStaging();
+
+					job->texture->bind();
+					job->pbo->bindUnpack();
+					for (integer_t level = 0; std::cmp_less(level, job->source->levels()); level++) {
+						impl::uploadLevel(*job->source, job->uploadFormat, level, true);
+					}
+					job->pbo->unbindUnpack();
+
+					this->stagingBytes -= te::safety_cast<integer_t>(job->staging.size());
+					job->staging = {};
+					job->pbo.reset();
+					job->source.reset();
+
+					job->stage = Stage::DONE;
+				} break;
+				case Stage::PARSING:
+				case Stage::STAGING:
+				case Stage::DONE:
+				case Stage::FAILED:
+				default:
+					break;
+			}
+		}
+
+		std::erase_if(this->jobs, [](auto const& job) {
+			return job->stage == Stage::DONE || job->stage == Stage::FAILED;
+		});
+	}
+
+	bool AsyncTextureLoader::done() const {
+		return this->jobs.empty();
+	}
+
+	AsyncTextureLoader::AsyncTextureLoader(OpenglContext& openglContext_, integer_t workerCount)
+	    : openglContext(openglContext_),
+	      workerPool(std::make_unique<WorkerPool>(workerCount)) {
+	}
+
+	AsyncTextureLoader::~AsyncTextureLoader() {
+		this->workerPool.reset();
+
+		for (auto& job : this->jobs) {
+			if (job->pbo.has_value() && job->pbo->bufferMapped) {
+				job->pbo->unmapStaging();
+			}
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <tepp/integers.h>
+#include <tepp/optional_ref.h>
+
+#include "render/Parallel.h"
+#include "render/opengl/OpenglTexture.h"
+
+namespace render::opengl
+{
+	struct DataSource;
+
+	namespace impl
+	{
+		struct AsyncTextureJob;
+	}
+
+	struct AsyncTexture
+	{
+		std::shared_ptr<impl::AsyncTextureJob> job{};
+
+		bool ready() const;
+		bool failed() const;
+
+		// Empty until the upload has been issued on the context thread.
+		te::optional_ref<Opengl2DTexture> get();
+	};
+
+	// Parses textures and copies their pixel data into mapped pixel unpack buffers on a worker pool.
+	// The context thread only maps and unmaps the staging buffers and issues the uploads from them.
+	struct AsyncTextureLoader
+	{
+		OpenglContext& openglContext;
+
+		// Parsed textures wait for staging memory while this much is mapped.
+		integer_t maxStagingBytes = 256 * 1024 * 1024;
+
+		AsyncTexture load(std::unique_ptr<DataSource> source, bool SRGB = true);
+
+		// Call once per frame on the thread owning the context.
+		void update();
+
+		bool done() const;
+
+		AsyncTextureLoader(OpenglContext& openglContext, integer_t workerCount = getWorkerCount());
+		~AsyncTextureLoader();
+
+		NO_COPY_MOVE(AsyncTextureLoader);
+
+	private:
+		integer_t stagingBytes = 0;
+		std::vector<std::shared_ptr<impl::AsyncTextureJob>> jobs{};
+		std::unique_ptr<WorkerPool> workerPool{};
+	};
+}
@@ -0,0 +1,546 @@
+#include "render/opengl/BlockCompression.h"
+
+#include "render/Parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define RENDER_BLOCK_COMPRESSION_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace render::opengl
+{
+	namespace
+	{
+		using PixelBlock = std::array<uint8_t, 16 * 4>;
+		using ChannelBlock = std::array<uint8_t, 16>;
+		using Endpoint = std::array<float, 3>;
+
+		struct BlockBounds
+		{
+			std::array<uint8_t, 4> min{};
+			std::array<uint8_t, 4> max{};
+		};
+
+		BlockBounds getBounds(PixelBlock const& block) {
+			BlockBounds result{};
+
+#ifdef RENDER_BLOCK_COMPRESSION_SSE2
+			auto p0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block.data()));
+			auto p1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block.data() + 16));
+			auto p2 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block.data() + 32));
+			auto p3 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block.data() + 48));
+
+			auto min = _mm_min_epu8(_mm_min_epu8(p0, p1), _mm_min_epu8(p2, p3));
+			auto max = _mm_max_epu8(_mm_max_epu8(p0, p1), _mm_max_epu8(p2, p3));
+
+			min = _mm_min_epu8(min, _mm_srli_si128(min, 8));
+			min = _mm_min_epu8(min, _mm_srli_si128(min, 4));
+			max = _mm_max_epu8(max, _mm_srli_si128(max, 8));
+			max = _mm_max_epu8(max, _mm_srli_si128(max, 4));
+
+			auto minPixel = _mm_cvtsi128_si32(min);
+			auto maxPixel = _mm_cvtsi128_si32(max);
+			std::memcpy(result.min.data(), &minPixel, 4);
+			std::memcpy(result.max.data(), &maxPixel, 4);
+#else
+			result.min.fill(255);
+			result.max.fill(0);
+
+			for (int i = 0; i < 16; i++) {
+				for (int c = 0; c < 4; c++) {
+					result.min[c] = std::min(result.min[c], block[i * 4 + c]);
+					result.max[c] = std::max(result.max[c], block[i * 4 + c]);
+				}
+			}
+#endif
+
+			return result;
+		}
+
+		uint16_t to565(Endpoint const& color) {
+			auto quantize = [](float v, int bits) {
+				auto max = (1 << bits) - 1;
+				return std::clamp(static_cast<int>(v * max / 255.0f + 0.5f), 0, max);
+			};
+
+			return static_cast<uint16_t>(
+			    (quantize(color[0], 5) << 11) | (quantize(color[1], 6) << 5) | quantize(color[2], 5)
+			);
+		}
+
+		std::array<int, 3> from565(uint16_t color) {
+			int r = (color >> 11) & 31;
+			int g = (color >> 5) & 63;
+			int b = color & 31;
+
+			return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+		}
+
+		struct ColorIndices
+		{
+			uint32_t indices{};
+			int32_t error{};
+		};
+
+		// Palette entries in index order: c0, c1, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1.
+		ColorIndices selectColorIndices(PixelBlock const& block, uint16_t c0, uint16_t c1) {
+			auto e0 = from565(c0);
+			auto e1 = from565(c1);
+
+			std::array<std::array<int, 3>, 4> palette{};
+			for (int c = 0; c < 3; c++) {
+				palette[0][c] = e0[c];
+				palette[1][c] = e1[c];
+				palette[2][c] = (2 * e0[c] + e1[c]) / 3;
+				palette[3][c] = (e0[c] + 2 * e1[c]) / 3;
+			}
+
+			int paletteSize = c0 > c1 ? 4 : 1;
+
+			ColorIndices result{};
+
+			for (int i = 0; i < 16; i++) {
+				int32_t bestError = std::numeric_limits<int32_t>::max();
+				uint32_t bestIndex = 0;
+
+				for (int p = 0; p < paletteSize; p++) {
+					int32_t error = 0;
+					for (int c = 0; c < 3; c++) {
+						auto d = static_cast<int32_t>(block[i * 4 + c]) - palette[p][c];
+						error += d * d;
+					}
+
+					if (error < bestError) {
+						bestError = error;
+						bestIndex = static_cast<uint32_t>(p);
+					}
+				}
+
+				result.indices |= bestIndex << (2 * i);
+				result.error += bestError;
+			}
+
+			return result;
+		}
+
+		void getPrincipalEndpoints(PixelBlock const& block, BlockBounds const& bounds, Endpoint& e0, Endpoint& e1) {
+			Endpoint mean{};
+			for (int i = 0; i < 16; i++) {
+				for (int c = 0; c < 3; c++) {
+					mean[c] += block[i * 4 + c];
+				}
+			}
+			for (auto& m : mean) {
+				m /= 16.0f;
+			}
+
+			std::array<float, 6> covariance{};
+			for (int i = 0; i < 16; i++) {
+				auto r = block[i * 4 + 0] - mean[0];
+				auto g = block[i * 4 + 1] - mean[1];
+				auto b = block[i * 4 + 2] - mean[2];
+
+				covariance[0] += r * r;
+				covariance[1] += r * g;
+				covariance[2] += r * b;
+				covariance[3] += g * g;
+				covariance[4] += g * b;
+				covariance[5] += b * b;
+			}
+
+			Endpoint axis{
+				static_cast<float>(bounds.max[0] - bounds.min[0]),
+				static_cast<float>(bounds.max[1] - bounds.min[1]),
+				static_cast<float>(bounds.max[2] - bounds.min[2]),
+			};
+
+			for (int iteration = 0; iteration < 8; iteration++) {
+				Endpoint next{
+					covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+					covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+					covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2],
+				};
+
+				auto length = std::max({ std::abs(next[0]), std::abs(next[1]), std::abs(next[2]) });
+				if (length < 1e-6f) {
+					break;
+				}
+
+				for (int c = 0; c < 3; c++) {
+					axis[c] = next[c] / length;
+				}
+			}
+
+			auto lengthSquared = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+			if (lengthSquared < 1e-6f) {
+				e0 = e1 = mean;
+				return;
+			}
+
+			float minT = std::numeric_limits<float>::max();
+			float maxT = std::numeric_limits<float>::lowest();
+			for (int i = 0; i < 16; i++) {
+				float t = 0.0f;
+				for (int c = 0; c < 3; c++) {
+					t += (block[i * 4 + c] - mean[c]) * axis[c];
+				}
+				minT = std::min(minT, t);
+				maxT = std::max(maxT, t);
+			}
+
+			for (int c = 0; c < 3; c++) {
+				e0[c] = std::clamp(mean[c] + axis[c] * maxT / lengthSquared, 0.0f, 255.0f);
+				e1[c] = std::clamp(mean[c] + axis[c] * minT / lengthSquared, 0.0f, 255.0f);
+			}
+		}
+
+		bool refineEndpoints(PixelBlock const& block, uint32_t indices, Endpoint& e0, Endpoint& e1) {
+			constexpr std::array<float, 4> weights{ 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+			float aa = 0.0f;
+			float ab = 0.0f;
+			float bb = 0.0f;
+			Endpoint ap{};
+			Endpoint bp{};
+
+			for (int i = 0; i < 16; i++) {
+				auto a = weights[(indices >> (2 * i)) & 3];
+				auto b = 1.0f - a;
+
+				aa += a * a;
+				ab += a * b;
+				bb += b * b;
+
+				for (int c = 0; c < 3; c++) {
+					ap[c] += a * block[i * 4 + c];
+					bp[c] += b * block[i * 4 + c];
+				}
+			}
+
+			auto determinant = aa * bb - ab * ab;
+			if (std::abs(determinant) < 1e-6f) {
+				return false;
+			}
+
+			for (int c = 0; c < 3; c++) {
+				e0[c] = std::clamp((bb * ap[c] - ab * bp[c]) / determinant, 0.0f, 255.0f);
+				e1[c] = std::clamp((aa * bp[c] - ab * ap[c]) / determinant, 0.0f, 255.0f);
+			}
+
+			return true;
+		}
+
+		void writeColorBlock(uint16_t c0, uint16_t c1, uint32_t indices, std::byte* out) {
+			std::array<uint8_t, 8> bytes{
+				static_cast<uint8_t>(c0 & 0xFF),
+				static_cast<uint8_t>(c0 >> 8),
+				static_cast<uint8_t>(c1 & 0xFF),
+				static_cast<uint8_t>(c1 >> 8),
+				static_cast<uint8_t>(indices & 0xFF),
+				static_cast<uint8_t>((indices >> 8) & 0xFF),
+				static_cast<uint8_t>((indices >> 16) & 0xFF),
+				static_cast<uint8_t>((indices >> 24) & 0xFF),
+			};
+
+			std::memcpy(out, bytes.data(), bytes.size());
+		}
+
+		void encodeColorBlock(PixelBlock const& block, CompressionQuality quality, std::byte* out) {
+			auto bounds = getBounds(block);
+
+			Endpoint e0{};
+			Endpoint e1{};
+
+			if (quality == CompressionQuality::FAST) {
+				for (int c = 0; c < 3; c++) {
+					auto inset = (bounds.max[c] - bounds.min[c]) / 16.0f;
+					e0[c] = bounds.max[c] - inset;
+					e1[c] = bounds.min[c] + inset;
+				}
+
+				Endpoint mean{};
+				for (int i = 0; i < 16; i++) {
+					for (int c = 0; c < 3; c++) {
+						mean[c] += block[i * 4 + c] / 16.0f;
+					}
+				}
+
+				float redGreen = 0.0f;
+				float blueGreen = 0.0f;
+				for (int i = 0; i < 16; i++) {
+					auto g = block[i * 4 + 1] - mean[1];
+					redGreen += (block[i * 4 + 0] - mean[0]) * g;
+					blueGreen += (block[i * 4 + 2] - mean[2]) * g;
+				}
+
+				if (redGreen < 0.0f) {
+					std::swap(e0[0], e1[0]);
+				}
+				if (blueGreen < 0.0f) {
+					std::swap(e0[2], e1[2]);
+				}
+			}
+			else {
+				getPrincipalEndpoints(block, bounds, e0, e1);
+			}
+
+			auto c0 = to565(e0);
+			auto c1 = to565(e1);
+			if (c0 < c1) {
+				std::swap(c0, c1);
+			}
+
+			auto best = selectColorIndices(block, c0, c1);
+
+			if (quality == CompressionQuality::QUALITY) {
+				for (int iteration = 0; iteration < 2 && best.error > 0 && c0 != c1; iteration++) {
+					if (!refineEndpoints(block, best.indices, e0, e1)) {
+						break;
+					}
+
+					auto r0 = to565(e0);
+					auto r1 = to565(e1);
+					if (r0 < r1) {
+						std::swap(r0, r1);
+					}
+
+					auto refined = selectColorIndices(block, r0, r1);
+					if (refined.error >= best.error) {
+						break;
+					}
+
+					best = refined;
+					c0 = r0;
+					c1 = r1;
+				}
+			}
+
+			writeColorBlock(c0, c1, best.indices, out);
+		}
+
+		struct ChannelIndices
+		{
+			uint64_t indices{};
+			int32_t error{};
+		};
+
+		ChannelIndices selectChannelIndices(ChannelBlock const& values, int r0, int r1) {
+			std::array<int, 8> palette{};
+			palette[0] = r0;
+			palette[1] = r1;
+
+			if (r0 > r1) {
+				for (int i = 2; i < 8; i++) {
+					palette[i] = ((8 - i) * r0 + (i - 1) * r1 + 3) / 7;
+				}
+			}
+			else {
+				for (int i = 2; i < 6; i++) {
+					palette[i] = ((6 - i) * r0 + (i - 1) * r1 + 2) / 5;
+				}
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+
+			ChannelIndices result{};
+
+			for (int i = 0; i < 16; i++) {
+				int32_t bestError = std::numeric_limits<int32_t>::max();
+				uint64_t bestIndex = 0;
+
+				for (int p = 0; p < 8; p++) {
+					auto d = static_cast<int32_t>(values[i]) - palette[p];
+					if (d * d < bestError) {
+						bestError = d * d;
+						bestIndex = static_cast<uint64_t>(p);
+					}
+				}
+
+				result.indices |= bestIndex << (3 * i);
+				result.error += bestError;
+			}
+
+			return result;
+		}
+
+		void encodeChannelBlock(ChannelBlock const& values, CompressionQuality quality, std::byte* out) {
+			auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end());
+			int min = *minIt;
+			int max = *maxIt;
+
+			int r0 = max;
+			int r1 = min;
+			auto best = selectChannelIndices(values, r0, r1);
+
+			if (quality == CompressionQuality::QUALITY && best.error > 0) {
+				for (int insetMax = 0; insetMax < 4; insetMax++) {
+					for (int insetMin = 0; insetMin < 4; insetMin++) {
+						auto c0 = max - insetMax;
+						auto c1 = min + insetMin;
+						if (c0 <= c1 || (insetMax == 0 && insetMin == 0)) {
+							continue;
+						}
+
+						auto candidate = selectChannelIndices(values, c0, c1);
+						if (candidate.error < best.error) {
+							best = candidate;
+							r0 = c0;
+							r1 = c1;
+						}
+					}
+				}
+
+				int innerMin = 255;
+				int innerMax = 0;
+				for (auto v : values) {
+					if (v != 0 && v != 255) {
+						innerMin = std::min(innerMin, static_cast<int>(v));
+						innerMax = std::max(innerMax, static_cast<int>(v));
+					}
+				}
+
+				if (innerMin <= innerMax) {
+					auto candidate = selectChannelIndices(values, innerMin, innerMax);
+					if (candidate.error < best.error) {
+						best = candidate;
+						r0 = innerMin;
+						r1 = innerMax;
+					}
+				}
+			}
+
+			std::array<uint8_t, 8> bytes{
+				static_cast<uint8_t>(r0),
+				static_cast<uint8_t>(r1),
+			};
+			for (int i = 0; i < 6; i++) {
+				bytes[2 + i] = static_cast<uint8_t>((best.indices >> (8 * i)) & 0xFF);
+			}
+
+			std::memcpy(out, bytes.data(), bytes.size());
+		}
+
+		ChannelBlock getChannel(PixelBlock const& block, int channel) {
+			ChannelBlock result{};
+			for (int i = 0; i < 16; i++) {
+				result[i] = block[i * 4 + channel];
+			}
+			return result;
+		}
+
+		void fetchBlock(te::span<std::byte const> level, glm::ivec2 levelSize, integer_t channels, integer_t blockX, integer_t blockY, PixelBlock& block) {
+			for (integer_t y = 0; y < 4; y++) {
+				auto sourceY = std::min(blockY * 4 + y, static_cast<integer_t>(levelSize.y - 1));
+
+				for (integer_t x = 0; x < 4; x++) {
+					auto sourceX = std::min(blockX * 4 + x, static_cast<integer_t>(levelSize.x - 1));
+					auto source = level.data() + (sourceY * levelSize.x + sourceX) * channels;
+					auto target = block.data() + (y * 4 + x) * 4;
+
+					for (integer_t c = 0; c < channels; c++) {
+						target[c] = static_cast<uint8_t>(source[c]);
+					}
+
+					if (channels == 3) {
+						target[3] = 255;
+					}
+				}
+			}
+		}
+	}
+
+	std::optional<CompressedImage> compressBlocks(
+	    TextureFormat const& sourceFormat,
+	    te::span<std::byte const> source,
+	    TextureFormat::PixelFormat targetFormat,
+	    CompressionQuality quality
+	) {
+		using PixelFormat = TextureFormat::PixelFormat;
+
+		if (sourceFormat.pixelFormat != PixelFormat::RGBA8 && sourceFormat.pixelFormat != PixelFormat::RGB8) {
+			return std::nullopt;
+		}
+
+		switch (targetFormat) {
+			case PixelFormat::BC1:
+			case PixelFormat::BC1_SRGB:
+			case PixelFormat::BC3:
+			case PixelFormat::BC3_SRGB:
+			case PixelFormat::BC4:
+			case PixelFormat::BC5:
+				break;
+			default:
+				return std::nullopt;
+		}
+
+		if (std::cmp_not_equal(sourceFormat.getMipChainByteSize(), source.size())) {
+			return std::nullopt;
+		}
+
+		CompressedImage result{};
+		result.textureFormat = sourceFormat;
+		result.textureFormat.pixelFormat = targetFormat;
+		result.data.resize(result.textureFormat.getMipChainByteSize());
+
+		auto channels = sourceFormat.channelCount();
+		auto blockByteSize = result.textureFormat.getPixelSize();
+
+		integer_t sourceOffset = 0;
+		integer_t targetOffset = 0;
+
+		for (integer_t level = 0; level < sourceFormat.mipmapLevels; level++) {
+			auto levelSize = sourceFormat.getLevelSize(level);
+			auto levelSource = source.subspan(sourceOffset, sourceFormat.getByteSize(level));
+			auto levelTarget = result.data.data() + targetOffset;
+
+			integer_t blocksX = (levelSize.x + 3) / 4;
+			integer_t blocksY = (levelSize.y + 3) / 4;
+
+			parallelFor(blocksY, [&](integer_t begin, integer_t end) {
+				PixelBlock block{};
+
+				for (integer_t blockY = begin; blockY < end; blockY++) {
+					for (integer_t blockX = 0; blockX < blocksX; blockX++) {
+						fetchBlock(levelSource, levelSize, channels, blockX, blockY, block);
+
+						auto out = levelTarget + (blockY * blocksX + blockX) * blockByteSize;
+
+						switch (targetFormat) {
+							case PixelFormat::BC1:
+							case PixelFormat::BC1_SRGB:
+								encodeColorBlock(block, quality, out);
+								break;
+							case PixelFormat::BC3:
+							case PixelFormat::BC3_SRGB:
+								encodeChannelBlock(getChannel(block, 3), quality, out);
+								encodeColorBlock(block, quality, out + 8);
+								break;
+							case PixelFormat::BC4:
+								encodeChannelBlock(getChannel(block, 0), quality, out);
+								break;
+							case PixelFormat::BC5:
+								encodeChannelBlock(getChannel(block, 0), quality, out);
+								encodeChannelBlock(getChannel(block, 1), quality, out + 8);
+								break;
+							default:
+								tassert(0);
+								break;
+						}
+					}
+				}
+			});
+
+			sourceOffset += sourceFormat.getByteSize(level);
+			targetOffset += result.textureFormat.getByteSize(level);
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include <tepp/span.h>
+
+#include "render/opengl/OpenglTexture.h"
+
+namespace render::opengl
+{
+	enum class CompressionQuality
+	{
+		FAST,
+		QUALITY,
+		MAX
+	};
+
+	struct CompressedImage
+	{
+		TextureFormat textureFormat{};
+		std::vector<std::byte> data{};
+	};
+
+	// Encodes RGBA8 or RGB8 pixel data into BC1, BC3, BC4 or BC5 blocks. The source holds
+	// sourceFormat.mipmapLevels levels back to back, every level is encoded. The result can be
+	// passed directly to Opengl2DTexture::make.
+	std::optional<CompressedImage> compressBlocks(
+	    TextureFormat const& sourceFormat,
+	    te::span<std::byte const> source,
+	    TextureFormat::PixelFormat targetFormat,
+	    CompressionQuality quality = CompressionQuality::FAST
+	);
+}
@@ -0,0 +1,219 @@
+#include "render/opengl/DDSHeader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace render::opengl
+{
+	namespace
+	{
+		constexpr uint32_t makeFourCC(char a, char b, char c, char d) {
+			return static_cast<uint32_t>(a)
+			       | (static_cast<uint32_t>(b) << 8)
+			       | (static_cast<uint32_t>(c) << 16)
+			       | (static_cast<uint32_t>(d) << 24);
+		}
+
+		constexpr std::size_t magicSize = 4;
+		constexpr std::size_t headerSize = 124;
+		constexpr std::size_t headerDX10Size = 20;
+
+		constexpr uint32_t DDPF_FOURCC = 0x4;
+		constexpr uint32_t DDPF_RGB = 0x40;
+		constexpr uint32_t DDPF_LUMINANCE = 0x20000;
+
+		constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+		constexpr uint32_t DDSCAPS2_VOLUME = 0x200000;
+
+		constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+		constexpr uint32_t DDS_DIMENSION_TEXTURE3D = 4;
+
+		// Upper bounds of GL_MAX_TEXTURE_SIZE and GL_MAX_ARRAY_TEXTURE_LAYERS on current hardware, larger
+		// values in a header can only come from a malformed file.
+		constexpr uint32_t maxTextureSize = 1 << 15;
+		constexpr uint32_t maxArrayLayers = 1 << 11;
+
+		uint32_t read(te::span<char const> buffer, std::size_t offset) {
+			uint32_t result{};
+			std::memcpy(&result, buffer.data() + offset, sizeof(result));
+			return result;
+		}
+
+		std::optional<TextureFormat::PixelFormat> getDXGIFormat(uint32_t format) {
+			using PixelFormat = TextureFormat::PixelFormat;
+
+			switch (format) {
+				case 6:
+					return PixelFormat::RGB32F;
+				case 28:
+					return PixelFormat::RGBA8;
+				case 41:
+					return PixelFormat::R32F;
+				case 54:
+					return PixelFormat::R16F;
+				case 56:
+					return PixelFormat::R16;
+				case 71:
+					return PixelFormat::BC1;
+				case 72:
+					return PixelFormat::BC1_SRGB;
+				case 74:
+					return PixelFormat::BC2;
+				case 77:
+					return PixelFormat::BC3;
+				case 78:
+					return PixelFormat::BC3_SRGB;
+				case 80:
+					return PixelFormat::BC4;
+				case 83:
+					return PixelFormat::BC5;
+				case 95:
+					return PixelFormat::BC6H;
+				case 98:
+					return PixelFormat::BC7;
+				case 99:
+					return PixelFormat::BC7_SRGB;
+				default:
+					return std::nullopt;
+			}
+		}
+
+		std::optional<TextureFormat::PixelFormat> getLegacyFormat(te::span<char const> buffer) {
+			using PixelFormat = TextureFormat::PixelFormat;
+
+			auto flags = read(buffer, magicSize + 76);
+			auto fourCC = read(buffer, magicSize + 80);
+			auto bitCount = read(buffer, magicSize + 84);
+			auto maskR = read(buffer, magicSize + 88);
+			auto maskG = read(buffer, magicSize + 92);
+			auto maskB = read(buffer, magicSize + 96);
+			auto maskA = read(buffer, magicSize + 100);
+
+			if (flags & DDPF_FOURCC) {
+				switch (fourCC) {
+					case makeFourCC('D', 'X', 'T', '1'):
+						return PixelFormat::BC1;
+					case makeFourCC('D', 'X', 'T', '3'):
+						return PixelFormat::BC2;
+					case makeFourCC('D', 'X', 'T', '5'):
+						return PixelFormat::BC3;
+					case makeFourCC('A', 'T', 'I', '1'):
+					case makeFourCC('B', 'C', '4', 'U'):
+						return PixelFormat::BC4;
+					case makeFourCC('A', 'T', 'I', '2'):
+					case makeFourCC('B', 'C', '5', 'U'):
+						return PixelFormat::BC5;
+					case 111:
+						return PixelFormat::R16F;
+					case 114:
+						return PixelFormat::R32F;
+					default:
+						return std::nullopt;
+				}
+			}
+
+			if ((flags & DDPF_RGB) && bitCount == 32 && maskR == 0x000000ff && maskG == 0x0000ff00 && maskB == 0x00ff0000 && (maskA == 0xff000000 || maskA == 0)) {
+				return PixelFormat::RGBA8;
+			}
+
+			if ((flags & DDPF_LUMINANCE) && bitCount == 16 && maskR == 0xffff) {
+				return PixelFormat::R16;
+			}
+
+			return std::nullopt;
+		}
+	}
+
+	std::optional<DDSImage> parseDDS(te::span<char const> buffer) {
+		if (buffer.size() < magicSize + headerSize) {
+			return std::nullopt;
+		}
+
+		if (read(buffer, 0) != makeFourCC('D', 'D', 'S', ' ') || read(buffer, magicSize) != headerSize) {
+			return std::nullopt;
+		}
+
+		auto height = read(buffer, magicSize + 8);
+		auto width = read(buffer, magicSize + 12);
+		auto mipMapCount = read(buffer, magicSize + 24);
+		auto fourCC = read(buffer, magicSize + 80);
+		auto caps2 = read(buffer, magicSize + 108);
+
+		if (caps2 & DDSCAPS2_VOLUME) {
+			return std::nullopt;
+		}
+
+		DDSImage result{};
+		result.cubemap = (caps2 & DDSCAPS2_CUBEMAP) != 0;
+
+		std::size_t dataOffset = magicSize + headerSize;
+		uint32_t arraySize = 1;
+
+		std::optional<TextureFormat::PixelFormat> pixelFormat{};
+
+		if (fourCC == makeFourCC('D', 'X', '1', '0')) {
+			if (buffer.size() < dataOffset + headerDX10Size) {
+				return std::nullopt;
+			}
+
+			pixelFormat = getDXGIFormat(read(buffer, dataOffset));
+
+			if (read(buffer, dataOffset + 4) == DDS_DIMENSION_TEXTURE3D) {
+				return std::nullopt;
+			}
+
+			result.cubemap = (read(buffer, dataOffset + 8) & DDS_RESOURCE_MISC_TEXTURECUBE) != 0;
+			arraySize = std::max(1u, read(buffer, dataOffset + 12));
+
+			dataOffset += headerDX10Size;
+		}
+		else {
+			pixelFormat = getLegacyFormat(buffer);
+		}
+
+		if (!pixelFormat.has_value() || width == 0 || height == 0) {
+			return std::nullopt;
+		}
+
+		if (width > maxTextureSize || height > maxTextureSize || arraySize > maxArrayLayers) {
+			return std::nullopt;
+		}
+
+		auto& textureFormat = result.textureFormat;
+		textureFormat.pixelFormat = pixelFormat.value();
+		textureFormat.size = { static_cast<int32_t>(width), static_cast<int32_t>(height) };
+		textureFormat.mipmapLevels = std::max(1, static_cast<int32_t>(mipMapCount));
+		textureFormat.layers = static_cast<int32_t>(arraySize) * (result.cubemap ? 6 : 1);
+
+		if (textureFormat.mipmapLevels > textureFormat.getMaxMipmapLevels()) {
+			return std::nullopt;
+		}
+
+		auto mipChainByteSize = textureFormat.getMipChainByteSize();
+
+		if (mipChainByteSize <= 0) {
+			return std::nullopt;
+		}
+
+		auto layers = static_cast<uint64_t>(textureFormat.layers);
+
+		if (static_cast<uint64_t>(mipChainByteSize) > std::numeric_limits<uint64_t>::max() / layers) {
+			return std::nullopt;
+		}
+
+		auto byteSize = static_cast<uint64_t>(mipChainByteSize) * layers;
+
+		if (buffer.size() - dataOffset < byteSize) {
+			return std::nullopt;
+		}
+
+		result.data = te::span<std::byte const>(
+		    reinterpret_cast<std::byte const*>(buffer.data() + dataOffset),
+		    static_cast<std::size_t>(byteSize)
+		);
+
+		return result;
+	}
+}
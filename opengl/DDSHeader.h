@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include <tepp/span.h>
+
+#include "render/opengl/OpenglTexture.h"
+
+namespace render::opengl
+{
+	struct DDSImage
+	{
+		// layers counts every array element and cube face.
+		TextureFormat textureFormat{};
+		bool cubemap = false;
+
+		// Points into the parsed buffer, each layer holds its full mip chain back to back.
+		te::span<std::byte const> data{};
+	};
+
+	// Reads the DDS header and the optional DX10 header without copying the payload. Only formats
+	// representable as a TextureFormat::PixelFormat are accepted, volume textures are rejected.
+	std::optional<DDSImage> parseDDS(te::span<char const> buffer);
+}
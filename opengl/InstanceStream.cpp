@@ -0,0 +1,146 @@
+#include "render/opengl/InstanceStream.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#include "render/opengl/OpenglContext.h"
+
+namespace render::opengl
+{
+	bool InstanceStreamBuffer::reserve(integer_t size) {
+		if (size <= this->capacity) {
+			return false;
+		}
+
+		this->capacity = std::max(size, this->capacity * 2);
+
+		this->buffer.bind(BufferTarget::Type::COPY_WRITE_BUFFER);
+		glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(this->capacity), nullptr, GL_DYNAMIC_DRAW);
+
+		return true;
+	}
+
+	void InstanceStreamBuffer::upload(te::span<std::byte const> data, te::span<DirtyRange const> ranges, integer_t elementSize) {
+		integer_t total = 0;
+		for (auto const& range : ranges) {
+			total += (range.end - range.begin) * elementSize;
+		}
+
+		if (total == 0) {
+			return;
+		}
+
+		tassert(total <= this->capacity);
+
+		this->openglContext.tallyBytesTransferred(total);
+
+		if (!this->persistent || !this->reserveStaging(total)) {
+			this->buffer.bind(BufferTarget::Type::COPY_WRITE_BUFFER);
+
+			for (auto const& range : ranges) {
+				auto offset = range.begin * elementSize;
+				auto size = (range.end - range.begin) * elementSize;
+				glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data.data() + offset);
+			}
+
+			return;
+		}
+
+		auto segment = this->frame % frameCount;
+		this->waitFence(segment);
+
+		this->staging->bind(BufferTarget::Type::COPY_READ_BUFFER);
+		this->buffer.bind(BufferTarget::Type::COPY_WRITE_BUFFER);
+
+		auto stagingOffset = segment * this->segmentSize;
+		for (auto const& range : ranges) {
+			auto offset = range.begin * elementSize;
+			auto size = (range.end - range.begin) * elementSize;
+
+			std::memcpy(this->stagingData + stagingOffset, data.data() + offset, static_cast<std::size_t>(size));
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(stagingOffset), static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+
+			stagingOffset += size;
+		}
+
+		this->fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		this->frame++;
+	}
+
+	bool InstanceStreamBuffer::reserveStaging(integer_t size) {
+		if (size <= this->segmentSize) {
+			return true;
+		}
+
+#ifndef WRANGLE_GLESv3
+		for (integer_t i = 0; i < frameCount; i++) {
+			if (this->fences[i] != nullptr) {
+				glDeleteSync(this->fences[i]);
+				this->fences[i] = nullptr;
+			}
+		}
+
+		// Deleting the mapped buffer unmaps it, pending copies from it still complete.
+		this->staging.reset();
+		this->stagingData = nullptr;
+		this->segmentSize = 0;
+
+		auto segmentSize_ = std::max<integer_t>(std::bit_ceil(static_cast<uint64_t>(size)), 1 << 16);
+		auto bufferSize = static_cast<GLsizeiptr>(segmentSize_ * frameCount);
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		this->staging.emplace(this->openglContext);
+		this->staging->bind(BufferTarget::Type::COPY_READ_BUFFER);
+		glBufferStorage(GL_COPY_READ_BUFFER, bufferSize, nullptr, flags);
+		auto ptr = glMapBufferRange(GL_COPY_READ_BUFFER, 0, bufferSize, flags);
+
+		if (ptr == nullptr) {
+			this->openglContext.logWarning("Failed to map instance staging buffer, falling back to glBufferSubData.\n");
+			this->staging.reset();
+			this->persistent = false;
+			return false;
+		}
+
+		this->stagingData = static_cast<std::byte*>(ptr);
+		this->segmentSize = segmentSize_;
+
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void InstanceStreamBuffer::waitFence(integer_t index) {
+		auto& fence = this->fences[index];
+
+		if (fence == nullptr) {
+			return;
+		}
+
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000) == GL_TIMEOUT_EXPIRED) {
+		}
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	InstanceStreamBuffer::InstanceStreamBuffer(OpenglContext& openglContext_)
+	    : openglContext(openglContext_),
+	      buffer(openglContext_) {
+#ifndef WRANGLE_GLESv3
+		auto version = std::pair(this->openglContext.majorVersion, this->openglContext.minorVersion);
+		this->persistent = !this->openglContext.isES()
+		                   && (version >= std::pair(4, 4) || this->openglContext.hasExtension("GL_ARB_buffer_storage"));
+#endif
+	}
+
+	InstanceStreamBuffer::~InstanceStreamBuffer() {
+		for (auto fence : this->fences) {
+			if (fence != nullptr) {
+				glDeleteSync(fence);
+			}
+		}
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <optional>
+
+#include <misc/Misc.h>
+
+#include <tepp/integers.h>
+#include <tepp/span.h>
+
+#include <wrangled_gl/wrangled_gl.h>
+
+#include "render/RenderInfoBase.h"
+#include "render/opengl/OpenglVBO.h"
+
+namespace render::opengl
+{
+	struct OpenglContext;
+
+	// GPU copy of an array that only receives the changed byte ranges. With buffer storage (GL 4.4 or
+	// ARB_buffer_storage) the ranges are written into a persistently mapped staging ring and copied into
+	// buffer on the GPU, which keeps the copy ordered after earlier draws reading buffer. Each upload
+	// uses the next ring segment and only waits on its fence when the GPU is frameCount uploads behind.
+	// Without buffer storage the ranges are written with glBufferSubData.
+	struct InstanceStreamBuffer
+	{
+		OpenglContext& openglContext;
+		OpenglVBO buffer;
+		integer_t capacity = 0;
+
+		bool persistent = false;
+
+		static constexpr integer_t frameCount = 3;
+
+		std::optional<OpenglVBO> staging{};
+		std::byte* stagingData = nullptr;
+		integer_t segmentSize = 0;
+
+		std::array<GLsync, frameCount> fences{};
+		integer_t frame = 0;
+
+		// Grows buffer to hold at least size bytes, returns true when the previous contents were lost.
+		bool reserve(integer_t size);
+
+		// Copies the elements in ranges from data into buffer.
+		void upload(te::span<std::byte const> data, te::span<DirtyRange const> ranges, integer_t elementSize);
+
+		InstanceStreamBuffer(OpenglContext& openglContext);
+		~InstanceStreamBuffer();
+
+		NO_COPY_MOVE(InstanceStreamBuffer);
+
+	private:
+		bool reserveStaging(integer_t size);
+		void waitFence(integer_t index);
+	};
+
+	// Keeps buffer in sync with one RenderInfoBase, consumes its dirty ranges on update.
+	template<class T>
+	struct InstanceStream
+	{
+		InstanceStreamBuffer stream;
+
+		void update(RenderInfoBase<T>& info) {
+			if (this->stream.reserve(info.size() * static_cast<integer_t>(sizeof(T)))) {
+				info.markAllDirty();
+			}
+
+			this->stream.upload(te::as_bytes(info.getData()), info.getDirtyRanges(), static_cast<integer_t>(sizeof(T)));
+			info.clearDirty();
+
+			this->stream.buffer.bufferSizeInformation.elementByteSize = static_cast<integer_t>(sizeof(T));
+			this->stream.buffer.bufferSizeInformation.elementCount = info.size();
+		}
+
+		OpenglVBO& getBuffer() {
+			return this->stream.buffer;
+		}
+
+		InstanceStream(OpenglContext& openglContext)
+		    : stream(openglContext) {
+		}
+
+		~InstanceStream() = default;
+
+		NO_COPY_MOVE(InstanceStream);
+	};
+}
@@ -1,8 +1,31 @@
 #include "render/opengl/ManagedTexture.h"
+#include "render/opengl/TextureLoader.h"
+#include "render/Hash.h"
 #include "tepp/nullopt.h"
 #include "tepp/optional.h"
+#include <array>
 #include <memory>
 
+#if defined(COMPILER_CLANGCL) || defined(COMPILER_CLANG)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-qualifiers"
+#pragma clang diagnostic ignored "-Wdeprecated-anon-enum-enum-conversion"
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wmissing-template-arg-list-after-template-kw"
+#elif defined(COMPILER_MSVC)
+#pragma warning(push, 0)
+#pragma warning(disable : 4201; disable : 4324; disable : 4310)
+#endif
+
+#include <gli/gli.hpp>
+
+#if defined(COMPILER_CLANGCL) || defined(COMPILER_CLANG)
+#pragma clang diagnostic pop
+#elif defined(COMPILER_MSVC)
+#pragma warning(pop)
+#endif
+
 namespace render::opengl
 {
 	te::optional_ref<Opengl2DTexture> ManagedTexture::get() {
@@ -82,4 +105,153 @@ namespace render::opengl
 		this->decrement();
 		this->data.reset();
 	}
+
+	ManagedTextureKey ManagedTextureKey::make(te::span<std::byte const> payload, te::span<int32_t const> formatKey) {
+		auto seed = hashBytes(te::as_bytes(formatKey));
+
+		return ManagedTextureKey{
+			.hash = hashBytes(payload, seed),
+			.check = hashBytes(payload, ~seed),
+			.byteSize = isize(payload),
+		};
+	}
+
+	std::optional<ManagedTextureStorage> ManagedTextureCache::make(TextureFormat const& textureFormat, te::span<std::byte const> data) {
+		// Storage only textures are written to after creation, every one of them needs its own texture.
+		if (data.empty()) {
+			auto texture = Opengl2DTexture::make(this->openglContext, textureFormat, data);
+
+			if (!texture.has_value()) {
+				return std::nullopt;
+			}
+
+			return ManagedTextureStorage::make(std::move(texture.value()));
+		}
+
+		std::array<int32_t, 9> formatKey{
+			0,
+			static_cast<int32_t>(textureFormat.pixelFormat.get()),
+			textureFormat.size.x,
+			textureFormat.size.y,
+			textureFormat.mipmapLevels,
+			static_cast<int32_t>(textureFormat.filtering.get()),
+			static_cast<int32_t>(textureFormat.mipmapFiltering.get()),
+			static_cast<int32_t>(textureFormat.wrappingX.get()),
+			static_cast<int32_t>(textureFormat.wrappingY.get()),
+		};
+
+		auto key = ManagedTextureKey::make(data, formatKey);
+
+		if (auto storage = this->find(key)) {
+			return storage;
+		}
+
+		auto texture = Opengl2DTexture::make(this->openglContext, textureFormat, data);
+
+		if (!texture.has_value()) {
+			return std::nullopt;
+		}
+
+		auto result = ManagedTextureStorage::make(std::move(texture.value()));
+		this->insert(key, result);
+
+		return result;
+	}
+
+	std::optional<ManagedTextureStorage> ManagedTextureCache::load2DTexture(te::span<char const> buffer, bool SRGB) {
+		gli::texture Texture = gli::load_dds(buffer.data(), buffer.size());
+
+		if (Texture.empty() || Texture.target() != gli::texture::target_type::TARGET_2D) {
+			return std::nullopt;
+		}
+
+		auto extent = Texture.extent();
+		auto swizzles = Texture.swizzles();
+
+		std::array<int32_t, 10> formatKey{
+			1,
+			SRGB,
+			static_cast<int32_t>(Texture.format()),
+			static_cast<int32_t>(extent.x),
+			static_cast<int32_t>(extent.y),
+			static_cast<int32_t>(Texture.levels()),
+			static_cast<int32_t>(swizzles[0]),
+			static_cast<int32_t>(swizzles[1]),
+			static_cast<int32_t>(swizzles[2]),
+			static_cast<int32_t>(swizzles[3]),
+		};
+
+		auto payload = te::span<std::byte const>(static_cast<std::byte const*>(Texture.data()), Texture.size());
+		auto key = ManagedTextureKey::make(payload, formatKey);
+
+		if (auto storage = this->find(key)) {
+			return storage;
+		}
+
+		auto loaded = impl::loadTexture(this->openglContext, Texture, SRGB);
+
+		if (!loaded.has_value()) {
+			return std::nullopt;
+		}
+
+		auto texture = std::get_if<Opengl2DTexture>(&loaded.value());
+
+		if (texture == nullptr || texture->ID.data == 0) {
+			return std::nullopt;
+		}
+
+		auto result = ManagedTextureStorage::make(std::move(*texture));
+		this->insert(key, result);
+
+		return result;
+	}
+
+	void ManagedTextureCache::collect() {
+		std::erase_if(this->storages, [](auto const& entry) {
+			return entry.second.storage.expired();
+		});
+	}
+
+	ManagedTextureCache::ManagedTextureCache(OpenglContext& openglContext_)
+	    : openglContext(openglContext_) {
+	}
+
+	std::optional<ManagedTextureStorage> ManagedTextureCache::find(ManagedTextureKey const& key) {
+		auto it = this->storages.find(key.hash);
+
+		if (it == this->storages.end()) {
+			return std::nullopt;
+		}
+
+		auto data = it->second.storage.lock();
+
+		if (data == nullptr) {
+			this->storages.erase(it);
+			return std::nullopt;
+		}
+
+		if (it->second.check != key.check || it->second.byteSize != key.byteSize) {
+			return std::nullopt;
+		}
+
+		auto result = ManagedTextureStorage();
+		result.data = std::move(data);
+
+		return result;
+	}
+
+	void ManagedTextureCache::insert(ManagedTextureKey const& key, ManagedTextureStorage const& storage) {
+		auto& entry = this->storages[key.hash];
+
+		// On a collision with a live texture the new one stays uncached.
+		if (!entry.storage.expired()) {
+			return;
+		}
+
+		entry = ManagedTextureCacheEntry{
+			.storage = storage.data,
+			.check = key.check,
+			.byteSize = key.byteSize,
+		};
+	}
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <unordered_map>
 
 #include "render/opengl/OpenglTexture.h"
 
@@ -48,4 +50,46 @@ namespace render::opengl
 
 		static ManagedTextureStorage make(render::opengl::Opengl2DTexture object);
 	};
+
+	// Identifies texture content by its pixel payload and format. hash picks the cache slot, check is a
+	// second hash with an independent seed that is compared together with byteSize on a hit.
+	struct ManagedTextureKey
+	{
+		uint64_t hash{};
+		uint64_t check{};
+		integer_t byteSize{};
+
+		static ManagedTextureKey make(te::span<std::byte const> payload, te::span<int32_t const> formatKey);
+	};
+
+	struct ManagedTextureCacheEntry
+	{
+		std::weak_ptr<ManagedTextureStorageInternal> storage{};
+		uint64_t check{};
+		integer_t byteSize{};
+	};
+
+	// Opt in deduplication of texture uploads. Textures are keyed by a hash of their payload and format,
+	// loading identical content again returns the storage that is already on the gpu. Only weak
+	// references are kept, a texture is freed when its last ManagedTextureStorage goes away. Only uploaded
+	// payloads are deduplicated, make with an empty data span always creates a new texture.
+	struct ManagedTextureCache
+	{
+		OpenglContext& openglContext;
+
+		std::unordered_map<uint64_t, ManagedTextureCacheEntry> storages{};
+
+		std::optional<ManagedTextureStorage> make(TextureFormat const& textureFormat, te::span<std::byte const> data);
+		std::optional<ManagedTextureStorage> load2DTexture(te::span<char const> buffer, bool SRGB = true);
+
+		// Drops entries of textures that have been freed.
+		void collect();
+
+		ManagedTextureCache(OpenglContext& openglContext);
+		~ManagedTextureCache() = default;
+
+	private:
+		std::optional<ManagedTextureStorage> find(ManagedTextureKey const& key);
+		void insert(ManagedTextureKey const& key, ManagedTextureStorage const& storage);
+	};
 }
@@ -0,0 +1,197 @@
+#include "render/opengl/Material.h"
+
+#include <algorithm>
+#include <array>
+
+#include "render/Hash.h"
+#include "render/opengl/OpenglSamplerObject.h"
+#include "render/opengl/OpenglTexture.h"
+
+namespace render::opengl
+{
+	namespace
+	{
+		integer_t getColumnCount(DataType dataType) {
+			switch (dataType) {
+				case DataType::mat2:
+				case DataType::mat2x3:
+				case DataType::mat2x4:
+					return 2;
+				case DataType::mat3:
+				case DataType::mat3x2:
+				case DataType::mat3x4:
+					return 3;
+				case DataType::mat4:
+				case DataType::mat4x2:
+				case DataType::mat4x3:
+					return 4;
+				default:
+					return 1;
+			}
+		}
+
+		integer_t alignUp(integer_t value, integer_t alignment) {
+			return (value + alignment - 1) / alignment * alignment;
+		}
+	}
+
+	integer_t MaterialBuffer::allocate(te::span<std::byte const> block) {
+		auto offset = alignUp(isize(this->data), this->alignment);
+
+		this->data.resize(offset + block.size());
+		std::ranges::copy(block, this->data.begin() + offset);
+		this->dirty = true;
+
+		return offset;
+	}
+
+	void MaterialBuffer::upload() {
+		this->buffer.set(te::span<std::byte const>(this->data), BufferUsageHint::Type::STATIC_DRAW, BufferTarget::Type::UNIFORM_BUFFER);
+		this->dirty = false;
+	}
+
+	MaterialBuffer::MaterialBuffer(OpenglContext& openglContext_)
+	    : openglContext(openglContext_),
+	      buffer(openglContext_) {
+		GLint offsetAlignment = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+
+		this->alignment = std::max(1_i, static_cast<integer_t>(offsetAlignment));
+	}
+
+	void Material::apply() const {
+		auto& openglContext = this->program->openglContext;
+
+		openglContext.setConfiguration(this->configuration);
+		this->program->use();
+
+		for (auto const& texture : this->textures) {
+			auto unit = static_cast<int32_t>(texture.unit);
+
+			openglContext.bind(texture.texture, texture.target, unit);
+
+			if (texture.sampler != nullptr) {
+				openglContext.bind(*texture.sampler, unit);
+			}
+			else {
+				openglContext.unbindSampler(unit);
+			}
+		}
+
+		if (this->size > 0) {
+			if (this->buffer->dirty) {
+				this->buffer->upload();
+			}
+
+			openglContext.bindUniformBuffer(this->buffer->buffer, this->binding, this->offset, this->size);
+		}
+	}
+
+	MaterialBuilder& MaterialBuilder::setBlock(std::string_view name, integer_t binding_) {
+		auto info = this->program.reflection.findBlock(name);
+
+		if (info == nullptr) {
+			this->program.openglContext.logWarning("Program has no active uniform block {}.\n", name);
+			return *this;
+		}
+
+		this->block = *info;
+		this->binding = binding_;
+		this->values.assign(static_cast<std::size_t>(info->dataSize), std::byte{});
+
+		return *this;
+	}
+
+	MaterialBuilder& MaterialBuilder::setConfiguration(Configuration const& configuration_) {
+		this->configuration = configuration_;
+		return *this;
+	}
+
+	MaterialBuilder& MaterialBuilder::setBytes(std::string_view name, te::span<std::byte const> bytes, DataType dataType) {
+		auto info = this->program.reflection.findUniform(name);
+
+		if (info == nullptr || !this->block.has_value() || info->blockIndex != static_cast<GLint>(this->block->index)) {
+			this->program.openglContext.logWarning("Material value {} is not part of the material block.\n", name);
+			return *this;
+		}
+
+		auto columns = getColumnCount(dataType);
+
+		if (columns > 1 && info->matrixStride > 0) {
+			auto columnSize = isize(bytes) / columns;
+
+			for (integer_t column = 0; column < columns; column++) {
+				auto offset = info->offset + column * info->matrixStride;
+				tassert(offset + columnSize <= isize(this->values));
+				std::ranges::copy(bytes.subspan(column * columnSize, columnSize), this->values.begin() + offset);
+			}
+		}
+		else {
+			tassert(info->offset + isize(bytes) <= isize(this->values));
+			std::ranges::copy(bytes, this->values.begin() + info->offset);
+		}
+
+		return *this;
+	}
+
+	MaterialBuilder& MaterialBuilder::set(OpenglSampler2D const& uniform, Opengl2DTexture const& texture, OpenglSamplerObject const* sampler) {
+		tassert(!uniform.units.empty());
+		this->textures.push_back({ uniform.units.front(), texture.ID, TextureTarget::Type::TEXTURE_2D, sampler });
+		return *this;
+	}
+
+	MaterialBuilder& MaterialBuilder::set(OpenglSampler3D const& uniform, Opengl3DTexture const& texture, OpenglSamplerObject const* sampler) {
+		this->textures.push_back({ uniform.unit, texture.ID, TextureTarget::Type::TEXTURE_3D, sampler });
+		return *this;
+	}
+
+	MaterialBuilder& MaterialBuilder::set(OpenglSamplerCube const& uniform, OpenglCubeTexture const& texture, OpenglSamplerObject const* sampler) {
+		this->textures.push_back({ uniform.unit, texture.ID, TextureTarget::Type::TEXTURE_CUBE_MAP, sampler });
+		return *this;
+	}
+
+	std::optional<Material> MaterialBuilder::build() {
+		if (!this->configuration.isComplete()) {
+			this->program.openglContext.logError("Material configurations need every field set.\n");
+			return std::nullopt;
+		}
+
+		Material result{};
+		result.program = &this->program;
+		result.configuration = this->configuration;
+		result.textures = this->textures;
+
+		std::ranges::sort(result.textures, {}, &MaterialTexture::unit);
+
+		if (this->block.has_value()) {
+			this->program.setBlockBinding(this->block->name, this->binding);
+
+			result.buffer = &this->buffer;
+			result.binding = this->binding;
+			result.offset = this->buffer.allocate(this->values);
+			result.size = isize(this->values);
+		}
+
+		uint64_t texturesHash = 0;
+		for (auto const& texture : result.textures) {
+			std::array<uint64_t, 3> values{
+				static_cast<uint64_t>(texture.unit),
+				static_cast<uint64_t>(texture.texture.data),
+				reinterpret_cast<std::uintptr_t>(texture.sampler),
+			};
+			texturesHash = hashBytes(te::as_bytes(te::span(values)), texturesHash);
+		}
+
+		result.sortKey = (static_cast<uint64_t>(this->program.ID.data & 0xffff) << 48)
+		                 | ((result.configuration.getHash() & 0xffff) << 32)
+		                 | ((texturesHash & 0xffff) << 16)
+		                 | (static_cast<uint64_t>(result.offset / this->buffer.alignment) & 0xffff);
+
+		return result;
+	}
+
+	MaterialBuilder::MaterialBuilder(Program& program_, MaterialBuffer& buffer_)
+	    : program(program_),
+	      buffer(buffer_) {
+	}
+}
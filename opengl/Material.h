@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <misc/Misc.h>
+
+#include <tepp/integers.h>
+#include <tepp/span.h>
+
+#include "render/opengl/OpenglContext.h"
+#include "render/opengl/OpenglVBO.h"
+#include "render/opengl/Uniforms.h"
+
+namespace render::opengl
+{
+	// One uniform buffer holding the parameter blocks of many materials, each block starts at a
+	// multiple of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT. Blocks are appended and the whole buffer is
+	// uploaded again when a material was added since the last upload.
+	struct MaterialBuffer
+	{
+		OpenglContext& openglContext;
+		OpenglVBO buffer;
+
+		integer_t alignment = 256;
+		std::vector<std::byte> data{};
+		bool dirty = false;
+
+		integer_t allocate(te::span<std::byte const> block);
+		void upload();
+
+		MaterialBuffer(OpenglContext& openglContext);
+		~MaterialBuffer() = default;
+
+		NO_COPY_MOVE(MaterialBuffer);
+	};
+
+	struct MaterialTexture
+	{
+		integer_t unit{};
+		Qualified<GLuint> texture{};
+		TextureTarget target{};
+		OpenglSamplerObject const* sampler = nullptr;
+	};
+
+	// Immutable bundle of a program, its configuration, texture bindings and a slice of a MaterialBuffer
+	// holding the values of one uniform block. Built with MaterialBuilder.
+	struct Material
+	{
+		Program* program{};
+		Configuration configuration{};
+		std::vector<MaterialTexture> textures{};
+
+		MaterialBuffer* buffer{};
+		integer_t binding{};
+		integer_t offset{};
+		integer_t size{};
+
+		// Program in the high bits, then configuration, textures and the buffer slice.
+		uint64_t sortKey{};
+
+		void apply() const;
+	};
+
+	struct MaterialBuilder
+	{
+		Program& program;
+		MaterialBuffer& buffer;
+
+		Configuration configuration = Configuration::getDefault();
+		std::vector<MaterialTexture> textures{};
+
+		// The uniform block holding the material values, bound to binding in every program it is used with.
+		std::optional<UniformBlockInfo> block{};
+		integer_t binding = 0;
+		std::vector<std::byte> values{};
+
+		MaterialBuilder& setBlock(std::string_view name, integer_t binding = 0);
+		MaterialBuilder& setConfiguration(Configuration const& configuration);
+
+		template<class T>
+		MaterialBuilder& set(std::string_view name, T const& value) {
+			return this->setBytes(name, te::as_bytes(te::span(&value, 1)), SetUniform<T>::dataType);
+		}
+
+		MaterialBuilder& setBytes(std::string_view name, te::span<std::byte const> bytes, DataType dataType);
+
+		MaterialBuilder& set(OpenglSampler2D const& uniform, Opengl2DTexture const& texture, OpenglSamplerObject const* sampler = nullptr);
+		MaterialBuilder& set(OpenglSampler3D const& uniform, Opengl3DTexture const& texture, OpenglSamplerObject const* sampler = nullptr);
+		MaterialBuilder& set(OpenglSamplerCube const& uniform, OpenglCubeTexture const& texture, OpenglSamplerObject const* sampler = nullptr);
+
+		std::optional<Material> build();
+
+		MaterialBuilder(Program& program, MaterialBuffer& buffer);
+		~MaterialBuilder() = default;
+	};
+}
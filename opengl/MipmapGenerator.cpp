@@ -0,0 +1,382 @@
+#include "render/opengl/MipmapGenerator.h"
+
+#include "render/Parallel.h"
+#include "render/SRGBConversion.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numbers>
+
+namespace render::opengl
+{
+	namespace
+	{
+		struct Tap
+		{
+			integer_t offset{};
+			float weight{};
+		};
+
+		float besselI0(float x) {
+			float sum = 1.0f;
+			float term = 1.0f;
+			for (int k = 1; k < 20; k++) {
+				auto f = x / (2.0f * static_cast<float>(k));
+				term *= f * f;
+				sum += term;
+			}
+			return sum;
+		}
+
+		float sinc(float x) {
+			if (std::abs(x) < 1e-6f) {
+				return 1.0f;
+			}
+			auto px = std::numbers::pi_v<float> * x;
+			return std::sin(px) / px;
+		}
+
+		// Taps relative to 2 * x for destination pixel x. Distances are measured in destination pixels
+		// between the destination center at 2x + 1 and the source center at 2x + offset + 0.5.
+		std::vector<Tap> getTaps(MipmapFilter filter) {
+			std::vector<Tap> result{};
+
+			switch (filter) {
+				case MipmapFilter::BOX:
+					result.push_back({ 0, 0.5f });
+					result.push_back({ 1, 0.5f });
+					break;
+				case MipmapFilter::KAISER:
+				{
+					constexpr float width = 3.0f;
+					constexpr float alpha = 4.0f;
+
+					float total = 0.0f;
+					for (integer_t offset = -6; offset <= 7; offset++) {
+						auto distance = (static_cast<float>(offset) - 0.5f) / 2.0f;
+						auto t = distance / width;
+						if (std::abs(t) >= 1.0f) {
+							continue;
+						}
+
+						auto window = besselI0(alpha * std::sqrt(1.0f - t * t)) / besselI0(alpha);
+						auto weight = sinc(distance) * window;
+
+						result.push_back({ offset, weight });
+						total += weight;
+					}
+
+					for (auto& tap : result) {
+						tap.weight /= total;
+					}
+				} break;
+				default:
+					tassert(0);
+					break;
+			}
+
+			return result;
+		}
+
+		integer_t sampleIndex(integer_t i, integer_t count, TextureFormat::Wrapping wrapping) {
+			switch (wrapping) {
+				case TextureFormat::Wrapping::REPEAT:
+					return ((i % count) + count) % count;
+				case TextureFormat::Wrapping::MIRRORED_REPEAT:
+				{
+					auto period = 2 * count;
+					auto m = ((i % period) + period) % period;
+					return m < count ? m : period - 1 - m;
+				}
+				default:
+					return std::clamp(i, 0_i, count - 1);
+			}
+		}
+
+		float fromHalf(uint16_t value) {
+			uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+			uint32_t exponent = (value >> 10) & 0x1F;
+			uint32_t mantissa = value & 0x3FF;
+
+			if (exponent == 0) {
+				auto v = std::ldexp(static_cast<float>(mantissa), -24);
+				return sign != 0 ? -v : v;
+			}
+			else if (exponent == 31) {
+				return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+			}
+			else {
+				return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+			}
+		}
+
+		uint16_t toHalf(float value) {
+			auto bits = std::bit_cast<uint32_t>(value);
+			uint32_t sign = (bits >> 16) & 0x8000;
+			uint32_t mantissa = bits & 0x7FFFFF;
+			int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+
+			if (((bits >> 23) & 0xFF) == 0xFF) {
+				return static_cast<uint16_t>(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+			}
+			else if (exponent >= 31) {
+				return static_cast<uint16_t>(sign | 0x7C00);
+			}
+			else if (exponent <= 0) {
+				if (exponent < -10) {
+					return static_cast<uint16_t>(sign);
+				}
+
+				mantissa |= 0x800000;
+				auto shift = static_cast<uint32_t>(14 - exponent);
+				auto half = mantissa >> shift;
+				if ((mantissa >> (shift - 1)) & 1) {
+					half++;
+				}
+				return static_cast<uint16_t>(sign | half);
+			}
+			else {
+				auto half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+				if (mantissa & 0x1000) {
+					half++;
+				}
+				return static_cast<uint16_t>(half);
+			}
+		}
+
+		struct SRGBTables
+		{
+			std::array<float, 256> toLinear{};
+			std::array<uint8_t, 4096> toSRGB{};
+
+			SRGBTables() {
+				for (integer_t i = 0; i < isize(this->toLinear); i++) {
+					this->toLinear[i] = ::toLinear(static_cast<float>(i) / 255.0f);
+				}
+
+				for (integer_t i = 0; i < isize(this->toSRGB); i++) {
+					auto v = ::toSRGB(static_cast<float>(i) / static_cast<float>(isize(this->toSRGB) - 1));
+					this->toSRGB[i] = static_cast<uint8_t>(std::clamp(v * 255.0f + 0.5f, 0.0f, 255.0f));
+				}
+			}
+		};
+
+		SRGBTables const& getSRGBTables() {
+			static SRGBTables const tables{};
+			return tables;
+		}
+
+		using PixelFormat = TextureFormat::PixelFormat;
+
+		bool isSupported(PixelFormat pixelFormat) {
+			switch (pixelFormat) {
+				case PixelFormat::RGBA8:
+				case PixelFormat::RGB8:
+				case PixelFormat::R16:
+				case PixelFormat::RGB16:
+				case PixelFormat::R16F:
+				case PixelFormat::R32F:
+				case PixelFormat::RGB32F:
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		// Channel c of an 8 bit format is sRGB encoded, alpha never is.
+		bool isSRGBChannel(bool SRGB, integer_t c) {
+			return SRGB && c < 3;
+		}
+
+		void decodeRow(PixelFormat pixelFormat, bool SRGB, integer_t channels, std::byte const* source, float* target, integer_t count) {
+			switch (pixelFormat) {
+				case PixelFormat::RGBA8:
+				case PixelFormat::RGB8:
+				{
+					auto const& tables = getSRGBTables();
+					auto bytes = reinterpret_cast<uint8_t const*>(source);
+					for (integer_t i = 0; i < count; i++) {
+						auto c = i % channels;
+						target[i] = isSRGBChannel(SRGB, c) ? tables.toLinear[bytes[i]] : bytes[i] / 255.0f;
+					}
+				} break;
+				case PixelFormat::R16:
+				case PixelFormat::RGB16:
+					for (integer_t i = 0; i < count; i++) {
+						uint16_t v{};
+						std::memcpy(&v, source + i * 2, 2);
+						target[i] = v / 65535.0f;
+					}
+					break;
+				case PixelFormat::R16F:
+					for (integer_t i = 0; i < count; i++) {
+						uint16_t v{};
+						std::memcpy(&v, source + i * 2, 2);
+						target[i] = fromHalf(v);
+					}
+					break;
+				case PixelFormat::R32F:
+				case PixelFormat::RGB32F:
+					std::memcpy(target, source, count * sizeof(float));
+					break;
+				default:
+					tassert(0);
+					break;
+			}
+		}
+
+		void encodeRow(PixelFormat pixelFormat, bool SRGB, integer_t channels, float const* source, std::byte* target, integer_t count) {
+			switch (pixelFormat) {
+				case PixelFormat::RGBA8:
+				case PixelFormat::RGB8:
+				{
+					auto const& tables = getSRGBTables();
+					constexpr auto tableMax = static_cast<float>(std::tuple_size_v<decltype(tables.toSRGB)> - 1);
+
+					auto bytes = reinterpret_cast<uint8_t*>(target);
+					for (integer_t i = 0; i < count; i++) {
+						auto v = std::clamp(source[i], 0.0f, 1.0f);
+						if (isSRGBChannel(SRGB, i % channels)) {
+							bytes[i] = tables.toSRGB[static_cast<integer_t>(v * tableMax + 0.5f)];
+						}
+						else {
+							bytes[i] = static_cast<uint8_t>(v * 255.0f + 0.5f);
+						}
+					}
+				} break;
+				case PixelFormat::R16:
+				case PixelFormat::RGB16:
+					for (integer_t i = 0; i < count; i++) {
+						auto v = static_cast<uint16_t>(std::clamp(source[i], 0.0f, 1.0f) * 65535.0f + 0.5f);
+						std::memcpy(target + i * 2, &v, 2);
+					}
+					break;
+				case PixelFormat::R16F:
+					for (integer_t i = 0; i < count; i++) {
+						auto v = toHalf(source[i]);
+						std::memcpy(target + i * 2, &v, 2);
+					}
+					break;
+				case PixelFormat::R32F:
+				case PixelFormat::RGB32F:
+					std::memcpy(target, source, count * sizeof(float));
+					break;
+				default:
+					tassert(0);
+					break;
+			}
+		}
+
+		// Vertical pass first: every tap is a whole source row, so the inner loop is a straight
+		// multiply-add over contiguous floats.
+		void filterVertical(std::vector<float> const& source, std::vector<float>& target, integer_t rowLength, integer_t height, integer_t targetHeight, te::span<Tap const> taps, TextureFormat::Wrapping wrapping) {
+			target.assign(rowLength * targetHeight, 0.0f);
+
+			parallelFor(targetHeight, [&](integer_t begin, integer_t end) {
+				for (integer_t y = begin; y < end; y++) {
+					auto out = target.data() + y * rowLength;
+
+					for (auto const& tap : taps) {
+						auto sourceY = sampleIndex(2 * y + tap.offset, height, wrapping);
+						auto in = source.data() + sourceY * rowLength;
+						auto weight = tap.weight;
+
+						for (integer_t i = 0; i < rowLength; i++) {
+							out[i] += weight * in[i];
+						}
+					}
+				}
+			});
+		}
+
+		void filterHorizontal(std::vector<float> const& source, std::vector<float>& target, integer_t channels, integer_t width, integer_t targetWidth, integer_t height, te::span<Tap const> taps, TextureFormat::Wrapping wrapping) {
+			target.assign(targetWidth * height * channels, 0.0f);
+
+			parallelFor(height, [&](integer_t begin, integer_t end) {
+				for (integer_t y = begin; y < end; y++) {
+					auto in = source.data() + y * width * channels;
+					auto out = target.data() + y * targetWidth * channels;
+
+					for (integer_t x = 0; x < targetWidth; x++) {
+						for (auto const& tap : taps) {
+							auto sourceX = sampleIndex(2 * x + tap.offset, width, wrapping);
+							auto weight = tap.weight;
+
+							for (integer_t c = 0; c < channels; c++) {
+								out[x * channels + c] += weight * in[sourceX * channels + c];
+							}
+						}
+					}
+				}
+			});
+		}
+	}
+
+	std::optional<MipChain> generateMipChain(
+	    TextureFormat const& textureFormat,
+	    te::span<std::byte const> level0,
+	    bool SRGB,
+	    MipmapFilter filter
+	) {
+		if (!isSupported(textureFormat.pixelFormat)) {
+			return std::nullopt;
+		}
+
+		if (std::cmp_not_equal(textureFormat.getByteSize(0), level0.size())) {
+			return std::nullopt;
+		}
+
+		auto pixelFormat = textureFormat.pixelFormat.get();
+		auto channels = textureFormat.channelCount();
+		auto componentSize = textureFormat.getPixelSize() / channels;
+		SRGB = SRGB && (pixelFormat == PixelFormat::RGBA8 || pixelFormat == PixelFormat::RGB8);
+
+		MipChain result{};
+		result.textureFormat = textureFormat;
+		result.textureFormat.mipmapLevels = std::clamp(textureFormat.mipmapLevels, 1, textureFormat.getMaxMipmapLevels());
+		result.data.resize(result.textureFormat.getMipChainByteSize());
+
+		std::ranges::copy(level0, result.data.begin());
+
+		auto taps = getTaps(filter);
+
+		auto size = result.textureFormat.getLevelSize(0);
+		std::vector<float> current(static_cast<size_t>(size.x) * size.y * channels);
+		std::vector<float> vertical{};
+		std::vector<float> next{};
+
+		parallelFor(size.y, [&](integer_t begin, integer_t end) {
+			auto rowLength = size.x * channels;
+			for (integer_t y = begin; y < end; y++) {
+				decodeRow(pixelFormat, SRGB, channels, level0.data() + y * rowLength * componentSize, current.data() + y * rowLength, rowLength);
+			}
+		});
+
+		integer_t offset = result.textureFormat.getByteSize(0);
+
+		for (integer_t level = 1; level < result.textureFormat.mipmapLevels; level++) {
+			auto targetSize = result.textureFormat.getLevelSize(level);
+
+			filterVertical(current, vertical, size.x * channels, size.y, targetSize.y, taps, textureFormat.wrappingY);
+			filterHorizontal(vertical, next, channels, size.x, targetSize.x, targetSize.y, taps, textureFormat.wrappingX);
+
+			auto levelData = result.data.data() + offset;
+			parallelFor(targetSize.y, [&](integer_t begin, integer_t end) {
+				auto rowLength = targetSize.x * channels;
+				for (integer_t y = begin; y < end; y++) {
+					encodeRow(pixelFormat, SRGB, channels, next.data() + y * rowLength, levelData + y * rowLength * componentSize, rowLength);
+				}
+			});
+
+			offset += result.textureFormat.getByteSize(level);
+			size = targetSize;
+			std::swap(current, next);
+		}
+
+		return result;
+	}
+}
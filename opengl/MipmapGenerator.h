@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include <tepp/span.h>
+
+#include "render/opengl/OpenglTexture.h"
+
+namespace render::opengl
+{
+	enum class MipmapFilter
+	{
+		BOX,
+		KAISER,
+		MAX
+	};
+
+	struct MipChain
+	{
+		TextureFormat textureFormat{};
+		std::vector<std::byte> data{};
+	};
+
+	// Builds textureFormat.mipmapLevels levels from level 0, each level is filtered from the previous one
+	// in floating point. With SRGB set, the color channels of 8 bit formats are filtered in linear space,
+	// leave it unset for normal maps, masks and other data textures.
+	// The result can be passed directly to Opengl2DTexture::make, which allocates it as an immutable mip chain.
+	std::optional<MipChain> generateMipChain(
+	    TextureFormat const& textureFormat,
+	    te::span<std::byte const> level0,
+	    bool SRGB,
+	    MipmapFilter filter = MipmapFilter::BOX
+	);
+}
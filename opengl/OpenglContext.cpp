@@ -1,6 +1,7 @@
 #include "render/opengl/OpenglContext.h"
 
 #include "misc/Logger.h"
+#include "render/Hash.h"
 #include "render/opengl/OpenglBufferTexture.h"
 #include "render/opengl/OpenglFramebuffer.h"
 #include "render/opengl/OpenglPBO.h"
@@ -8,14 +9,25 @@
 #include "render/opengl/OpenglVAO.h"
 #include "render/opengl/OpenglVBO.h"
 #include "render/opengl/Program.h"
+#include "render/opengl/ProgramWarmup.h"
 
 #include <tepp/safety_cast.h>
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <ranges>
 
 namespace render::opengl
 {
+	bool OpenglContext::hasExtension(std::string_view name) const {
+		return std::ranges::binary_search(this->extensions, name, std::less<>{});
+	}
+
+	bool OpenglContext::isES() const {
+		return this->shaderVersion == ShaderVersion::version_320_es;
+	}
+
 	te::cstring_view OpenglContext::getShaderPrefix() const {
 		return shaderPrefixes[this->shaderVersion];
 	}
@@ -260,6 +272,25 @@ namespace render::opengl
 		}
 	}
 
+	void OpenglContext::bindUniformBuffer(OpenglVBO& buffer, integer_t binding, integer_t offset, integer_t size) {
+		if (isize(this->boundUniformBuffers) <= binding) {
+			LOGWARNING("Trying to bind uniform buffer {} to binding {}, but only {} bindings available", buffer.ID.data, binding, isize(this->boundUniformBuffers));
+			return;
+		}
+
+		auto& bound = this->boundUniformBuffers[binding];
+
+		if (bound.buffer != buffer.ID || bound.offset != offset || bound.size != size) {
+			glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(binding), buffer.ID.data, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+
+			bound.buffer = buffer.ID;
+			bound.offset = offset;
+			bound.size = size;
+
+			this->boundBuffers[BufferTarget::Type::UNIFORM_BUFFER] = buffer.ID;
+		}
+	}
+
 	void OpenglContext::bindTextureUnit(integer_t unit) {
 		if (this->activeUnit != unit) {
 			glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + unit));
@@ -273,6 +304,8 @@ namespace render::opengl
 			glUseProgram(program.ID.data);
 			this->usedProgram = program.ID;
 		}
+
+		program.flushUniforms();
 	}
 
 	void OpenglContext::bind(Qualified<GLuint> ID, TextureTarget target, int32_t unit) {
@@ -314,6 +347,22 @@ namespace render::opengl
 		this->bind(texture.ID, TextureTarget::Type::TEXTURE_2D_ARRAY, unit);
 	}
 
+	void OpenglContext::bind(OpenglCubeTexture const& texture) {
+		this->bind(texture, 0);
+	}
+
+	void OpenglContext::bind(OpenglCubeTexture const& texture, int32_t unit) {
+		this->bind(texture.ID, TextureTarget::Type::TEXTURE_CUBE_MAP, unit);
+	}
+
+	void OpenglContext::bind(Opengl3DTexture const& texture) {
+		this->bind(texture, 0);
+	}
+
+	void OpenglContext::bind(Opengl3DTexture const& texture, int32_t unit) {
+		this->bind(texture.ID, TextureTarget::Type::TEXTURE_3D, unit);
+	}
+
 	void OpenglContext::bind(OpenglBufferTexture const& texture) {
 		this->bind(texture, 0);
 	}
@@ -329,6 +378,43 @@ namespace render::opengl
 		}
 	}
 
+	OpenglSamplerObject const& OpenglContext::getSampler(SamplerParameters const& parameters) {
+		auto& sampler = this->samplerObjects[parameters];
+
+		if (sampler == nullptr) {
+			sampler = std::make_unique<OpenglSamplerObject>(*this, parameters);
+		}
+
+		return *sampler;
+	}
+
+	void OpenglContext::bind(OpenglSamplerObject const& sampler, int32_t unit) {
+		if (isize(this->boundSamplerUnits) <= unit) {
+			LOGWARNING("Trying to bind sampler {} to sampler unit {}, but only {} sampler units available", sampler.ID.data, unit, isize(this->boundSamplerUnits));
+			return;
+		}
+
+		auto& samplerUnitInfo = this->boundSamplerUnits[unit];
+
+		if (samplerUnitInfo.sampler != sampler.ID) {
+			glBindSampler(static_cast<GLuint>(unit), sampler.ID.data);
+			samplerUnitInfo.sampler = sampler.ID;
+		}
+	}
+
+	void OpenglContext::unbindSampler(int32_t unit) {
+		if (isize(this->boundSamplerUnits) <= unit) {
+			return;
+		}
+
+		auto& samplerUnitInfo = this->boundSamplerUnits[unit];
+
+		if (samplerUnitInfo.sampler) {
+			glBindSampler(static_cast<GLuint>(unit), 0);
+			samplerUnitInfo.sampler = {};
+		}
+	}
+
 	void OpenglContext::setViewport(glm::ivec4 viewport_) {
 		if (this->viewport != viewport_) {
 			this->viewport = viewport_;
@@ -356,6 +442,7 @@ namespace render::opengl
 		this->boundBuffers.fill({});
 		this->configuration = {};
 		this->boundTextures.fill({});
+		std::ranges::fill(this->boundUniformBuffers, UniformBufferBinding{});
 
 		{
 			integer_t unit = 0;
@@ -365,10 +452,13 @@ namespace render::opengl
 					glBindTexture(samplerUnitInfo.type.get(), 0);
 				}
 
+				if (samplerUnitInfo.sampler) {
+					glBindSampler(static_cast<GLuint>(unit), 0);
+				}
+
 				samplerUnitInfo = {};
+				unit++;
 			}
-
-			unit++;
 		}
 
 		this->activeUnit = 0;
@@ -407,6 +497,10 @@ namespace render::opengl
 
 	void OpenglContext::tallyDrawCall() {
 		this->bytesTransferredThisFrame.drawCalls++;
+
+		if (this->programWarmup != nullptr) {
+			this->programWarmup->record();
+		}
 	}
 
 	void OpenglContext::tallyBytesTransferred(integer_t bytes) {
@@ -430,11 +524,56 @@ namespace render::opengl
 		glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &maximumTextureUnits);
 
 		this->boundSamplerUnits.resize(maximumTextureUnits);
+
+		int maximumUniformBufferBindings = 0;
+		glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maximumUniformBufferBindings);
+
+		this->boundUniformBuffers.resize(maximumUniformBufferBindings);
+
+		glGetIntegerv(GL_MAJOR_VERSION, &this->majorVersion);
+		glGetIntegerv(GL_MINOR_VERSION, &this->minorVersion);
+
+		GLint extensionCount = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+		for (GLint i = 0; i < extensionCount; i++) {
+			auto extension = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+			if (extension != nullptr) {
+				this->extensions.emplace_back(reinterpret_cast<char const*>(extension));
+			}
+		}
+
+		std::ranges::sort(this->extensions);
 	}
 
 	OpenglContext::~OpenglContext() {
 	}
 
+	bool Configuration::isComplete() const {
+		return this->blend != Blend::UNSET
+		       && this->blendFunc != BlendFunc::UNSET
+		       && this->blendEquation != BlendEquation::UNSET
+		       && this->depthTest != DepthTest::UNSET
+		       && this->depthFunc != DepthFunc::UNSET
+		       && this->depthMask != DepthMask::UNSET
+		       && this->srgbMode != SRGBMode::UNSET;
+	}
+
+	uint64_t Configuration::getHash() const {
+		std::array<uint32_t, 8> values{
+			static_cast<uint32_t>(this->blend),
+			static_cast<uint32_t>(this->blendFunc),
+			static_cast<uint32_t>(this->blendEquation),
+			static_cast<uint32_t>(this->depthTest),
+			static_cast<uint32_t>(this->depthFunc),
+			std::bit_cast<uint32_t>(this->pointSize),
+			static_cast<uint32_t>(this->depthMask),
+			static_cast<uint32_t>(this->srgbMode),
+		};
+
+		return hashBytes(te::as_bytes(te::span(values)));
+	}
+
 	Configuration Configuration::getDefault() {
 		return Configuration{
 			.blend = Blend::ENABLED,
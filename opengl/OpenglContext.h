@@ -2,6 +2,10 @@
 
 #include <format>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <wrangled_gl/wrangled_gl.h>
 
@@ -9,6 +13,8 @@
 #include <tepp/enum_array.h>
 
 #include "render/opengl/BufferTarget.h"
+#include "render/opengl/OpenglSamplerObject.h"
+#include "render/opengl/ProgramBinaryCache.h"
 #include "render/opengl/ProgramRegistry.h"
 #include "render/opengl/Qualifier.h"
 #include "render/opengl/TextureTarget.h"
@@ -22,9 +28,12 @@ namespace render::opengl
 	struct Opengl2DTexture;
 	struct OpenglBufferTexture;
 	struct Opengl2DArrayTexture;
+	struct OpenglCubeTexture;
+	struct Opengl3DTexture;
 	struct OpenglFramebuffer;
 	struct OpenglVBO;
 	struct Program;
+	struct ProgramWarmup;
 
 	enum class DepthMask
 	{
@@ -111,6 +120,12 @@ namespace render::opengl
 		DepthMask depthMask = DepthMask::UNSET;
 		SRGBMode srgbMode = SRGBMode::UNSET;
 
+		bool operator==(Configuration const& other) const = default;
+
+		// All fields set, only complete configurations can be passed to setConfiguration.
+		bool isComplete() const;
+		uint64_t getHash() const;
+
 		static Configuration getDefault();
 	};
 
@@ -130,10 +145,20 @@ namespace render::opengl
 		{
 			Qualified<GLuint> texture{};
 			TextureTarget type{};
+			Qualified<GLuint> sampler{};
 		};
 		std::vector<SamplerUnitInfo> boundSamplerUnits{};
+		std::unordered_map<SamplerParameters, std::unique_ptr<OpenglSamplerObject>, SamplerParameters::Hasher> samplerObjects{};
 		integer_t activeUnit = 0;
 
+		struct UniformBufferBinding
+		{
+			Qualified<GLuint> buffer{};
+			integer_t offset{};
+			integer_t size{};
+		};
+		std::vector<UniformBufferBinding> boundUniformBuffers{};
+
 		glm::ivec4 viewport{};
 
 		std::ostream* out = &std::cout;
@@ -142,6 +167,16 @@ namespace render::opengl
 
 		ProgramRegistry programRegistry{};
 
+		// Draw calls are recorded into this when set, see tallyDrawCall.
+		ProgramWarmup* programWarmup = nullptr;
+
+		std::vector<std::string> extensions{};
+		GLint majorVersion = 0;
+		GLint minorVersion = 0;
+
+		// Programs loaded from source are restored from and stored in this cache when set.
+		std::optional<ProgramBinaryCache> programBinaryCache{};
+
 		struct BytesTransferredInfo
 		{
 			integer_t bufferDataCalls{};
@@ -167,6 +202,9 @@ namespace render::opengl
 			{ ShaderVersion::version_320_es, "#version 320 es\nprecision mediump float;\n" },
 		};
 
+		bool hasExtension(std::string_view name) const;
+		bool isES() const;
+
 		te::cstring_view getShaderPrefix() const;
 
 		std::string_view trimShaderPrefix(std::string_view shaderSource);
@@ -195,9 +233,18 @@ namespace render::opengl
 		void bind(Opengl2DTexture const& texture, int32_t unit);
 		void bind(Opengl2DArrayTexture const& texture);
 		void bind(Opengl2DArrayTexture const& texture, int32_t unit);
+		void bind(OpenglCubeTexture const& texture);
+		void bind(OpenglCubeTexture const& texture, int32_t unit);
+		void bind(Opengl3DTexture const& texture);
+		void bind(Opengl3DTexture const& texture, int32_t unit);
 		void bind(OpenglBufferTexture const& texture);
 		void bind(OpenglBufferTexture const& texture, int32_t unit);
 		void bind(OpenglFramebuffer& framebuffer);
+		void bindUniformBuffer(OpenglVBO& buffer, integer_t binding, integer_t offset, integer_t size);
+
+		OpenglSamplerObject const& getSampler(SamplerParameters const& parameters);
+		void bind(OpenglSamplerObject const& sampler, int32_t unit);
+		void unbindSampler(int32_t unit);
 
 		void setViewport(glm::ivec4 viewport);
 
@@ -64,6 +64,24 @@ namespace render::opengl
 
 		auto& textureFormat = this->uploadFormat.value();
 
+		if (textureFormat.isCompressed()) {
+			auto levelSize = textureFormat.getLevelSize(level);
+
+			glCompressedTexSubImage2D(
+			    GL_TEXTURE_2D,
+			    static_cast<GLint>(level),
+			    0,
+			    0,
+			    levelSize.x,
+			    levelSize.y,
+			    textureFormat.getInternalFormat(),
+			    static_cast<GLsizei>(textureFormat.getByteSize(level)),
+			    nullptr
+			);
+
+			return;
+		}
+
 		glTexImage2D(
 		    GL_TEXTURE_2D,
 		    static_cast<GLint>(level),
@@ -86,6 +104,43 @@ namespace render::opengl
 		}
 	}
 
+	std::optional<te::span<std::byte>> OpenglPBO::mapStaging(integer_t size) {
+		if (this->bufferMapped) {
+			tassert(0);
+			return std::nullopt;
+		}
+
+		this->bindUnpack();
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+		auto ptr = glMapBufferRange(
+		    GL_PIXEL_UNPACK_BUFFER,
+		    0,
+		    static_cast<GLsizeiptr>(size),
+		    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+		);
+		this->unbindUnpack();
+
+		if (ptr == nullptr) {
+			return std::nullopt;
+		}
+
+		this->bufferMapped = true;
+
+		return te::span<std::byte>(static_cast<std::byte*>(ptr), static_cast<std::size_t>(size));
+	}
+
+	void OpenglPBO::unmapStaging() {
+		if (!this->bufferMapped) {
+			tassert(0);
+			return;
+		}
+
+		this->bindUnpack();
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		this->bufferMapped = false;
+		this->unbindUnpack();
+	}
+
 	void OpenglPBO::unmapPBO() {
 		this->bindPack();
 		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
@@ -83,6 +83,11 @@ namespace render::opengl
 		    Opengl2DTexture& texture
 		);
 
+		// Allocates size bytes of unpack storage and maps it for writing. The mapping may be
+		// filled from any thread, it has to be unmapped on the context thread before uploading from it.
+		std::optional<te::span<std::byte>> mapStaging(integer_t size);
+		void unmapStaging();
+
 		template<class T>
 		friend struct OpenglPBOMappedRead;
 
@@ -131,11 +136,11 @@ namespace render::opengl
 
 		this->uploadFormat = dummy;
 
-		integer_t bufferSize = dummy.getPixelCount() * sizeof(T);
+		integer_t bufferSize = dummy.isCompressed() ? dummy.getByteSize(level) : dummy.getPixelCount() * sizeof(T);
 		glBufferData(GL_PIXEL_UNPACK_BUFFER, bufferSize, nullptr, GL_STREAM_READ);
 		auto ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bufferSize), GL_WRITE_ONLY);
 
-		auto span = te::span<T>(reinterpret_cast<T*>(ptr), texture.textureFormat.getPixelCount());
+		auto span = te::span<T>(reinterpret_cast<T*>(ptr), bufferSize / sizeof(T));
 
 		this->unbindUnpack();
 		return OpenglPBOMappedWrite<T>(*this, span);
@@ -0,0 +1,73 @@
+#include "render/opengl/OpenglSamplerObject.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "render/Hash.h"
+#include "render/opengl/OpenglContext.h"
+
+namespace render::opengl
+{
+	namespace
+	{
+		// -0.0f compares equal to 0.0f, so both have to hash the same.
+		uint32_t getFloatBits(float value) {
+			return value == 0.0f ? 0 : std::bit_cast<uint32_t>(value);
+		}
+	}
+
+	std::size_t SamplerParameters::Hasher::operator()(SamplerParameters const& parameters) const {
+		std::array<uint32_t, 9> values{
+			static_cast<uint32_t>(parameters.minFilter),
+			static_cast<uint32_t>(parameters.magFilter),
+			static_cast<uint32_t>(parameters.wrapS),
+			static_cast<uint32_t>(parameters.wrapT),
+			static_cast<uint32_t>(parameters.wrapR),
+			getFloatBits(parameters.minLod),
+			getFloatBits(parameters.maxLod),
+			getFloatBits(parameters.lodBias),
+			getFloatBits(parameters.maxAnisotropy),
+		};
+
+		return static_cast<std::size_t>(hashBytes(te::as_bytes(te::span(values))));
+	}
+
+	SamplerParameters SamplerParameters::make(TextureFormat const& textureFormat) {
+		SamplerParameters result{};
+		result.minFilter = textureFormat.getMinFilter();
+		result.magFilter = textureFormat.getMagFilter();
+		result.wrapS = textureFormat.getWrappingX();
+		result.wrapT = textureFormat.getWrappingY();
+		result.wrapR = textureFormat.getWrappingX();
+		return result;
+	}
+
+	OpenglSamplerObject::OpenglSamplerObject(OpenglContext& openglContext, SamplerParameters const& parameters_)
+	    : parameters(parameters_) {
+		this->ID.qualifier = openglContext.getQualifier();
+		glGenSamplers(1, &this->ID.data);
+
+		glSamplerParameteri(this->ID.data, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(this->parameters.minFilter));
+		glSamplerParameteri(this->ID.data, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(this->parameters.magFilter));
+		glSamplerParameteri(this->ID.data, GL_TEXTURE_WRAP_S, static_cast<GLint>(this->parameters.wrapS));
+		glSamplerParameteri(this->ID.data, GL_TEXTURE_WRAP_T, static_cast<GLint>(this->parameters.wrapT));
+		glSamplerParameteri(this->ID.data, GL_TEXTURE_WRAP_R, static_cast<GLint>(this->parameters.wrapR));
+		glSamplerParameterf(this->ID.data, GL_TEXTURE_MIN_LOD, this->parameters.minLod);
+		glSamplerParameterf(this->ID.data, GL_TEXTURE_MAX_LOD, this->parameters.maxLod);
+
+#ifndef WRANGLE_GLESv3
+		glSamplerParameterf(this->ID.data, GL_TEXTURE_LOD_BIAS, this->parameters.lodBias);
+#endif
+
+#ifdef GL_TEXTURE_MAX_ANISOTROPY_EXT
+		if (this->parameters.maxAnisotropy > 1.0f) {
+			glSamplerParameterf(this->ID.data, GL_TEXTURE_MAX_ANISOTROPY_EXT, this->parameters.maxAnisotropy);
+		}
+#endif
+	}
+
+	OpenglSamplerObject::~OpenglSamplerObject() {
+		glDeleteSamplers(1, &this->ID.data);
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+#include <wrangled_gl/wrangled_gl.h>
+
+#include <misc/Misc.h>
+
+#include "render/opengl/OpenglTexture.h"
+#include "render/opengl/Qualifier.h"
+
+namespace render::opengl
+{
+	struct OpenglContext;
+
+	struct SamplerParameters
+	{
+		GLenum minFilter = GL_LINEAR;
+		GLenum magFilter = GL_LINEAR;
+		GLenum wrapS = GL_REPEAT;
+		GLenum wrapT = GL_REPEAT;
+		GLenum wrapR = GL_REPEAT;
+		float minLod = -1000.0f;
+		float maxLod = 1000.0f;
+		float lodBias = 0.0f;
+		float maxAnisotropy = 1.0f;
+
+		bool operator==(SamplerParameters const& other) const = default;
+
+		struct Hasher
+		{
+			std::size_t operator()(SamplerParameters const& parameters) const;
+		};
+
+		// Takes over the filtering and wrapping that would otherwise be baked into a texture with textureFormat.
+		static SamplerParameters make(TextureFormat const& textureFormat);
+	};
+
+	// Sampling state separate from the texture, shared instances are handed out by OpenglContext::getSampler.
+	struct OpenglSamplerObject
+	{
+		Qualified<GLuint> ID{};
+		SamplerParameters parameters{};
+
+		OpenglSamplerObject(OpenglContext& openglContext, SamplerParameters const& parameters);
+		~OpenglSamplerObject();
+
+		NO_COPY_MOVE(OpenglSamplerObject);
+	};
+}
@@ -2,6 +2,8 @@
 
 #include <tepp/enum_array.h>
 
+#include <bit>
+
 #include "render/opengl/OpenglContext.h"
 #include "render/opengl/OpenglFramebuffer.h"
 
@@ -18,11 +20,56 @@ namespace render::opengl
 #endif
 			{ PixelFormat::RGB8, GL_RGB8 },
 			{ PixelFormat::RGBA8, GL_RGBA8 },
+#ifndef WRANGLE_GLESv3
+			{ PixelFormat::BC1, GL_COMPRESSED_RGB_S3TC_DXT1_EXT },
+			{ PixelFormat::BC1_SRGB, GL_COMPRESSED_SRGB_S3TC_DXT1_EXT },
+			{ PixelFormat::BC2, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT },
+			{ PixelFormat::BC3, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT },
+			{ PixelFormat::BC3_SRGB, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT },
+			{ PixelFormat::BC4, GL_COMPRESSED_RED_RGTC1 },
+			{ PixelFormat::BC5, GL_COMPRESSED_RG_RGTC2 },
+			{ PixelFormat::BC6H, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT },
+			{ PixelFormat::BC7, GL_COMPRESSED_RGBA_BPTC_UNORM },
+			{ PixelFormat::BC7_SRGB, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM },
+#endif
+			{ PixelFormat::ETC2_RGB8, GL_COMPRESSED_RGB8_ETC2 },
+			{ PixelFormat::ETC2_RGBA8, GL_COMPRESSED_RGBA8_ETC2_EAC },
+			{ PixelFormat::ASTC_4x4, GL_COMPRESSED_RGBA_ASTC_4x4_KHR },
 		};
 
 		return lookup[this->pixelFormat];
 	}
 
+	bool TextureFormat::isCompressed() const {
+		switch (this->pixelFormat) {
+			case PixelFormat::BC1:
+			case PixelFormat::BC1_SRGB:
+			case PixelFormat::BC2:
+			case PixelFormat::BC3:
+			case PixelFormat::BC3_SRGB:
+			case PixelFormat::BC4:
+			case PixelFormat::BC5:
+			case PixelFormat::BC6H:
+			case PixelFormat::BC7:
+			case PixelFormat::BC7_SRGB:
+			case PixelFormat::ETC2_RGB8:
+			case PixelFormat::ETC2_RGBA8:
+			case PixelFormat::ASTC_4x4:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	glm::ivec2 TextureFormat::getBlockExtent() const {
+		if (this->isCompressed()) {
+			return { 4, 4 };
+		}
+		else {
+			return { 1, 1 };
+		}
+	}
+
 	GLsizei TextureFormat::getWidth() const {
 		return static_cast<GLsizei>(this->size.x);
 	}
@@ -93,6 +140,11 @@ namespace render::opengl
 		}
 	}
 
+	int32_t TextureFormat::getMaxMipmapLevels() const {
+		auto largest = std::max(1, std::max(this->size.x, this->size.y));
+		return static_cast<int32_t>(std::bit_width(static_cast<uint32_t>(largest)));
+	}
+
 	GLenum TextureFormat::getMagFilter() const {
 		constexpr te::enum_array<Filtering, GLenum> lookup{
 			{ Filtering::LINEAR, GL_LINEAR },
@@ -121,12 +173,41 @@ namespace render::opengl
 		return getWrapping(this->wrappingY);
 	}
 
+	glm::ivec2 TextureFormat::getLevelSize(integer_t level) const {
+		return {
+			std::max(1, this->size.x >> level),
+			std::max(1, this->size.y >> level),
+		};
+	}
+
 	integer_t TextureFormat::getPixelCount() const {
 		return static_cast<integer_t>(this->size.x) * this->size.y;
 	}
 
+	integer_t TextureFormat::getBlockCount(integer_t level) const {
+		auto levelSize = this->getLevelSize(level);
+		auto blockExtent = this->getBlockExtent();
+
+		integer_t blocksX = (levelSize.x + blockExtent.x - 1) / blockExtent.x;
+		integer_t blocksY = (levelSize.y + blockExtent.y - 1) / blockExtent.y;
+
+		return blocksX * blocksY;
+	}
+
 	integer_t TextureFormat::getByteSize() const {
-		return this->getPixelCount() * this->getPixelSize();
+		return this->getByteSize(0);
+	}
+
+	integer_t TextureFormat::getByteSize(integer_t level) const {
+		return this->getBlockCount(level) * this->getPixelSize();
+	}
+
+	integer_t TextureFormat::getMipChainByteSize() const {
+		integer_t result = 0;
+		for (integer_t level = 0; level < this->mipmapLevels; level++) {
+			result += this->getByteSize(level);
+		}
+		return result;
 	}
 
 	integer_t TextureFormat::getPixelSize() const {
@@ -138,6 +219,19 @@ namespace render::opengl
 			{ PixelFormat::RGB16, 2 * 3 },
 			{ PixelFormat::RGB8, 1 * 3 },
 			{ PixelFormat::RGBA8, 1 * 4 },
+			{ PixelFormat::BC1, 8 },
+			{ PixelFormat::BC1_SRGB, 8 },
+			{ PixelFormat::BC2, 16 },
+			{ PixelFormat::BC3, 16 },
+			{ PixelFormat::BC3_SRGB, 16 },
+			{ PixelFormat::BC4, 8 },
+			{ PixelFormat::BC5, 16 },
+			{ PixelFormat::BC6H, 16 },
+			{ PixelFormat::BC7, 16 },
+			{ PixelFormat::BC7_SRGB, 16 },
+			{ PixelFormat::ETC2_RGB8, 8 },
+			{ PixelFormat::ETC2_RGBA8, 16 },
+			{ PixelFormat::ASTC_4x4, 16 },
 		};
 
 		return lookup[this->pixelFormat];
@@ -152,6 +246,19 @@ namespace render::opengl
 			{ PixelFormat::RGB16, 3 },
 			{ PixelFormat::RGB8, 3 },
 			{ PixelFormat::RGBA8, 4 },
+			{ PixelFormat::BC1, 3 },
+			{ PixelFormat::BC1_SRGB, 3 },
+			{ PixelFormat::BC2, 4 },
+			{ PixelFormat::BC3, 4 },
+			{ PixelFormat::BC3_SRGB, 4 },
+			{ PixelFormat::BC4, 1 },
+			{ PixelFormat::BC5, 2 },
+			{ PixelFormat::BC6H, 3 },
+			{ PixelFormat::BC7, 4 },
+			{ PixelFormat::BC7_SRGB, 4 },
+			{ PixelFormat::ETC2_RGB8, 3 },
+			{ PixelFormat::ETC2_RGBA8, 4 },
+			{ PixelFormat::ASTC_4x4, 4 },
 		};
 
 		return lookup[this->pixelFormat];
@@ -281,6 +388,16 @@ namespace render::opengl
 
 		result.textureFormat = textureFormat;
 
+		auto mipChain = textureFormat.mipmapLevels > 1 && data.has_value() && std::cmp_equal(textureFormat.getMipChainByteSize(), data->size());
+
+		if (textureFormat.isCompressed() || mipChain) {
+			if (!result.makeImmutableStorage(data)) {
+				return std::nullopt;
+			}
+
+			return result;
+		}
+
 		void const* ptr = nullptr;
 
 		if (data.has_value() && !data->empty()) {
@@ -293,6 +410,7 @@ namespace render::opengl
 			ptr = data->data();
 		}
 
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 		glTexImage2D(
 		    GL_TEXTURE_2D,
 		    0,
@@ -304,6 +422,7 @@ namespace render::opengl
 		    textureFormat.getPixelDataType(),
 		    ptr
 		);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, textureFormat.getMagFilter());
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, textureFormat.getMinFilter());
@@ -317,6 +436,72 @@ namespace render::opengl
 		return result;
 	}
 
+	bool Opengl2DTexture::makeImmutableStorage(std::optional<te::span<std::byte const>> data) {
+		auto const& format = this->textureFormat;
+		auto internalFormat = static_cast<GLenum>(format.getInternalFormat());
+
+		if (data.has_value() && !data->empty() && std::cmp_not_equal(format.getMipChainByteSize(), data->size())) {
+			this->openglContext.logError("Mismatched byte size when trying to load texture mip chain. Wanted {} for {} levels, have {}.\n", format.getMipChainByteSize(), format.mipmapLevels, data->size());
+
+			return false;
+		}
+
+		glTexStorage2D(
+		    GL_TEXTURE_2D,
+		    format.mipmapLevels,
+		    internalFormat,
+		    format.size.x,
+		    format.size.y
+		);
+
+		if (data.has_value() && !data->empty()) {
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+			integer_t offset = 0;
+			for (integer_t level = 0; level < format.mipmapLevels; level++) {
+				auto levelSize = format.getLevelSize(level);
+				auto levelByteSize = format.getByteSize(level);
+
+				if (format.isCompressed()) {
+					glCompressedTexSubImage2D(
+					    GL_TEXTURE_2D,
+					    static_cast<GLint>(level),
+					    0,
+					    0,
+					    levelSize.x,
+					    levelSize.y,
+					    internalFormat,
+					    static_cast<GLsizei>(levelByteSize),
+					    data->data() + offset
+					);
+				}
+				else {
+					glTexSubImage2D(
+					    GL_TEXTURE_2D,
+					    static_cast<GLint>(level),
+					    0,
+					    0,
+					    levelSize.x,
+					    levelSize.y,
+					    format.getPixelDataFormat(),
+					    format.getPixelDataType(),
+					    data->data() + offset
+					);
+				}
+
+				offset += levelByteSize;
+			}
+
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, format.mipmapLevels - 1);
+		this->refreshFiltering();
+
+		return true;
+	}
+
 	void Opengl2DArrayTexture::bind() {
 		this->openglContext.get().bind(*this);
 	}
@@ -351,6 +536,26 @@ namespace render::opengl
 		result.size = textureFormat.size;
 		result.layers = textureFormat.layers;
 
+		if (textureFormat.isCompressed()) {
+			glTexStorage3D(
+			    GL_TEXTURE_2D_ARRAY,
+			    textureFormat.mipmapLevels,
+			    static_cast<GLenum>(textureFormat.getInternalFormat()),
+			    textureFormat.size.x,
+			    textureFormat.size.y,
+			    textureFormat.layers
+			);
+
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, textureFormat.getMagFilter());
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, textureFormat.getMinFilter());
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, textureFormat.getWrappingX());
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, textureFormat.getWrappingY());
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, textureFormat.mipmapLevels - 1);
+
+			return result;
+		}
+
 		for (int i = 0; i < textureFormat.mipmapLevels; i++) {
 			glTexImage3D(
 			    GL_TEXTURE_2D_ARRAY,
@@ -376,4 +581,258 @@ namespace render::opengl
 
 		return result;
 	}
+
+	void OpenglCubeTexture::bind() {
+		this->openglContext.get().bind(*this);
+	}
+
+	OpenglCubeTexture::OpenglCubeTexture(OpenglContext& openglContext_)
+	    : openglContext(openglContext_) {
+		this->ID.qualifier = this->openglContext.get().getQualifier();
+	}
+
+	OpenglCubeTexture::OpenglCubeTexture(OpenglContext& openglContext_, GLuint ID)
+	    : openglContext(openglContext_) {
+		this->ID.data = ID;
+		this->ID.qualifier = this->openglContext.get().getQualifier();
+	}
+
+	OpenglCubeTexture::OpenglCubeTexture(OpenglCubeTexture&& other)
+	    : openglContext(other.openglContext) {
+		this->ID = other.ID;
+		other.ID.clear();
+
+		this->textureFormat = other.textureFormat;
+	}
+
+	OpenglCubeTexture& OpenglCubeTexture::operator=(OpenglCubeTexture&& other) {
+		tassert(&this->openglContext.get() == &other.openglContext.get());
+
+		glDeleteTextures(1, &this->ID.data);
+
+		this->ID = other.ID;
+		other.ID.clear();
+
+		this->textureFormat = other.textureFormat;
+
+		return *this;
+	}
+
+	OpenglCubeTexture::~OpenglCubeTexture() {
+		glDeleteTextures(1, &this->ID.data);
+	}
+
+	std::optional<OpenglCubeTexture> OpenglCubeTexture::make(OpenglContext& openglContext, TextureFormat const& textureFormat, std::optional<te::span<std::byte const>> data) {
+		int32_t maxSize = 0;
+		glGetIntegerv(GL_MAX_CUBE_MAP_TEXTURE_SIZE, &maxSize);
+
+		if (textureFormat.size.x != textureFormat.size.y) {
+			openglContext.logError("Tried to make cube texture with non square faces {} {}.\n", textureFormat.size.x, textureFormat.size.y);
+			return std::nullopt;
+		}
+
+		if (textureFormat.size.x > maxSize) {
+			openglContext.logError("Tried to make cube texture with size {}, maximum size supported is {}.\n", textureFormat.size.x, maxSize);
+			return std::nullopt;
+		}
+
+		auto faceByteSize = textureFormat.getMipChainByteSize();
+
+		if (data.has_value() && !data->empty() && std::cmp_not_equal(faceByteSize * 6, data->size())) {
+			openglContext.logError("Mismatched byte size when trying to load cube texture. Wanted {}, have {}.\n", faceByteSize * 6, data->size());
+			return std::nullopt;
+		}
+
+		auto result = OpenglCubeTexture(openglContext);
+		glGenTextures(1, &result.ID.data);
+		result.bind();
+
+		result.textureFormat = textureFormat;
+
+		auto internalFormat = static_cast<GLenum>(textureFormat.getInternalFormat());
+
+		glTexStorage2D(
+		    GL_TEXTURE_CUBE_MAP,
+		    textureFormat.mipmapLevels,
+		    internalFormat,
+		    textureFormat.size.x,
+		    textureFormat.size.y
+		);
+
+		if (data.has_value() && !data->empty()) {
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+			integer_t offset = 0;
+			for (int32_t face = 0; face < 6; face++) {
+				auto target = static_cast<GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face);
+
+				for (integer_t level = 0; level < textureFormat.mipmapLevels; level++) {
+					auto levelSize = textureFormat.getLevelSize(level);
+					auto levelByteSize = textureFormat.getByteSize(level);
+
+					if (textureFormat.isCompressed()) {
+						glCompressedTexSubImage2D(
+						    target,
+						    static_cast<GLint>(level),
+						    0,
+						    0,
+						    levelSize.x,
+						    levelSize.y,
+						    internalFormat,
+						    static_cast<GLsizei>(levelByteSize),
+						    data->data() + offset
+						);
+					}
+					else {
+						glTexSubImage2D(
+						    target,
+						    static_cast<GLint>(level),
+						    0,
+						    0,
+						    levelSize.x,
+						    levelSize.y,
+						    textureFormat.getPixelDataFormat(),
+						    textureFormat.getPixelDataType(),
+						    data->data() + offset
+						);
+					}
+
+					offset += levelByteSize;
+				}
+			}
+
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, textureFormat.getMagFilter());
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, textureFormat.getMinFilter());
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, textureFormat.mipmapLevels - 1);
+
+		return result;
+	}
+
+	void Opengl3DTexture::bind() {
+		this->openglContext.get().bind(*this);
+	}
+
+	Opengl3DTexture::Opengl3DTexture(OpenglContext& openglContext_)
+	    : openglContext(openglContext_) {
+		this->ID.qualifier = this->openglContext.get().getQualifier();
+	}
+
+	Opengl3DTexture::Opengl3DTexture(OpenglContext& openglContext_, GLuint ID)
+	    : openglContext(openglContext_) {
+		this->ID.data = ID;
+		this->ID.qualifier = this->openglContext.get().getQualifier();
+	}
+
+	Opengl3DTexture::Opengl3DTexture(Opengl3DTexture&& other)
+	    : openglContext(other.openglContext) {
+		this->ID = other.ID;
+		other.ID.clear();
+
+		this->textureFormat = other.textureFormat;
+	}
+
+	Opengl3DTexture& Opengl3DTexture::operator=(Opengl3DTexture&& other) {
+		tassert(&this->openglContext.get() == &other.openglContext.get());
+
+		glDeleteTextures(1, &this->ID.data);
+
+		this->ID = other.ID;
+		other.ID.clear();
+
+		this->textureFormat = other.textureFormat;
+
+		return *this;
+	}
+
+	Opengl3DTexture::~Opengl3DTexture() {
+		glDeleteTextures(1, &this->ID.data);
+	}
+
+	std::optional<Opengl3DTexture> Opengl3DTexture::make(OpenglContext& openglContext, TextureFormat const& textureFormat, std::optional<te::span<std::byte const>> data) {
+		int32_t maxSize = 0;
+		glGetIntegerv(GL_MAX_3D_TEXTURE_SIZE, &maxSize);
+
+		if (textureFormat.size.x > maxSize || textureFormat.size.y > maxSize || textureFormat.layers > maxSize) {
+			openglContext.logError("Tried to make 3D texture with size {} {} {}, maximum size supported is {}.\n", textureFormat.size.x, textureFormat.size.y, textureFormat.layers, maxSize);
+			return std::nullopt;
+		}
+
+		if (textureFormat.isCompressed()) {
+			openglContext.logError("Block compressed formats are not supported for 3D textures.\n");
+			return std::nullopt;
+		}
+
+		auto getDepth = [&](integer_t level) {
+			return std::max(1, textureFormat.layers >> level);
+		};
+
+		integer_t byteSize = 0;
+		for (integer_t level = 0; level < textureFormat.mipmapLevels; level++) {
+			byteSize += textureFormat.getByteSize(level) * getDepth(level);
+		}
+
+		if (data.has_value() && !data->empty() && std::cmp_not_equal(byteSize, data->size())) {
+			openglContext.logError("Mismatched byte size when trying to load 3D texture. Wanted {}, have {}.\n", byteSize, data->size());
+			return std::nullopt;
+		}
+
+		auto result = Opengl3DTexture(openglContext);
+		glGenTextures(1, &result.ID.data);
+		result.bind();
+
+		result.textureFormat = textureFormat;
+
+		glTexStorage3D(
+		    GL_TEXTURE_3D,
+		    textureFormat.mipmapLevels,
+		    static_cast<GLenum>(textureFormat.getInternalFormat()),
+		    textureFormat.size.x,
+		    textureFormat.size.y,
+		    textureFormat.layers
+		);
+
+		if (data.has_value() && !data->empty()) {
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+			integer_t offset = 0;
+			for (integer_t level = 0; level < textureFormat.mipmapLevels; level++) {
+				auto levelSize = textureFormat.getLevelSize(level);
+
+				glTexSubImage3D(
+				    GL_TEXTURE_3D,
+				    static_cast<GLint>(level),
+				    0,
+				    0,
+				    0,
+				    levelSize.x,
+				    levelSize.y,
+				    getDepth(level),
+				    textureFormat.getPixelDataFormat(),
+				    textureFormat.getPixelDataType(),
+				    data->data() + offset
+				);
+
+				offset += textureFormat.getByteSize(level) * getDepth(level);
+			}
+
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, textureFormat.getMagFilter());
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, textureFormat.getMinFilter());
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, textureFormat.getWrappingX());
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, textureFormat.getWrappingY());
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, textureFormat.getWrappingX());
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAX_LEVEL, textureFormat.mipmapLevels - 1);
+
+		return result;
+	}
 }
@@ -50,12 +50,28 @@ namespace render::opengl
 	X(RGB32F) \
 	X(R16) \
 	X(RGB16) \
-	X(RGB8)
+	X(RGB8) \
+	X(BC1) \
+	X(BC1_SRGB) \
+	X(BC2) \
+	X(BC3) \
+	X(BC3_SRGB) \
+	X(BC4) \
+	X(BC5) \
+	X(BC6H) \
+	X(BC7) \
+	X(BC7_SRGB) \
+	X(ETC2_RGB8) \
+	X(ETC2_RGBA8) \
+	X(ASTC_4x4)
 
 		MAKE_CHOICE_ENUM_STRUCT(PixelFormat, pixelFormat, LIST)
 
 		GLint getInternalFormat() const;
 
+		bool isCompressed() const;
+		glm::ivec2 getBlockExtent() const;
+
 		glm::ivec2 size{};
 
 		GLsizei getWidth() const;
@@ -77,6 +93,8 @@ namespace render::opengl
 
 		int32_t mipmapLevels = 1;
 
+		int32_t getMaxMipmapLevels() const;
+
 #undef LIST
 #define LIST(X) \
 	X(NEAREST) \
@@ -97,8 +115,15 @@ namespace render::opengl
 		GLenum getWrappingX() const;
 		GLenum getWrappingY() const;
 
+		glm::ivec2 getLevelSize(integer_t level) const;
+
 		integer_t getPixelCount() const;
+		integer_t getBlockCount(integer_t level = 0) const;
 		integer_t getByteSize() const;
+		integer_t getByteSize(integer_t level) const;
+		integer_t getMipChainByteSize() const;
+
+		// Size of a single block in bytes, a block is one pixel for uncompressed formats.
 		integer_t getPixelSize() const;
 		integer_t channelCount() const;
 	};
@@ -135,6 +160,9 @@ namespace render::opengl
 		~Opengl2DTexture();
 
 		static std::optional<Opengl2DTexture> make(OpenglContext& openglContext, TextureFormat const& textureFormat, std::optional<te::span<std::byte const>> data);
+
+	private:
+		bool makeImmutableStorage(std::optional<te::span<std::byte const>> data);
 	};
 
 	struct Opengl2DArrayTexture
@@ -157,6 +185,51 @@ namespace render::opengl
 
 		static std::optional<Opengl2DArrayTexture> make(OpenglContext& openglContext, TextureFormat const& textureFormat);
 	};
+
+	struct OpenglCubeTexture
+	{
+		std::reference_wrapper<OpenglContext> openglContext;
+		Qualified<GLuint> ID{};
+		TextureFormat textureFormat{};
+
+		void bind();
+
+		explicit OpenglCubeTexture(OpenglContext& openglContext);
+		explicit OpenglCubeTexture(OpenglContext& openglContext, GLuint ID);
+
+		NO_COPY(OpenglCubeTexture);
+		OpenglCubeTexture(OpenglCubeTexture&& other);
+		OpenglCubeTexture& operator=(OpenglCubeTexture&& other);
+
+		OpenglCubeTexture() = delete;
+		~OpenglCubeTexture();
+
+		// data holds the faces in +X, -X, +Y, -Y, +Z, -Z order, each face with its full mip chain.
+		static std::optional<OpenglCubeTexture> make(OpenglContext& openglContext, TextureFormat const& textureFormat, std::optional<te::span<std::byte const>> data);
+	};
+
+	struct Opengl3DTexture
+	{
+		std::reference_wrapper<OpenglContext> openglContext;
+		Qualified<GLuint> ID{};
+		// layers is the depth of the texture.
+		TextureFormat textureFormat{};
+
+		void bind();
+
+		explicit Opengl3DTexture(OpenglContext& openglContext);
+		explicit Opengl3DTexture(OpenglContext& openglContext, GLuint ID);
+
+		NO_COPY(Opengl3DTexture);
+		Opengl3DTexture(Opengl3DTexture&& other);
+		Opengl3DTexture& operator=(Opengl3DTexture&& other);
+
+		Opengl3DTexture() = delete;
+		~Opengl3DTexture();
+
+		// data holds every level back to back, a level holds its slices back to back.
+		static std::optional<Opengl3DTexture> make(OpenglContext& openglContext, TextureFormat const& textureFormat, std::optional<te::span<std::byte const>> data);
+	};
 }
 
 #undef COMMA
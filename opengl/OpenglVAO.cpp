@@ -81,120 +81,47 @@ namespace render::opengl
 		return *this;
 	}
 
-	void floatVertex(GLint index, GLint size, GLsizei stride, void* offset, GLuint divisor) {
-		glVertexAttribPointer(
-		    index,
-		    size,
-		    GL_FLOAT,
-		    GL_FALSE,
-		    stride,
-		    offset
-		);
-		glVertexAttribDivisor(index, divisor);
-		glEnableVertexAttribArray(index);
-	}
+	Descriptor& Descriptor::add(te::span<VertexAttribute const> attributes_, GLsizei stride_) {
+		for (auto attribute : attributes_) {
+			attribute.offset += this->stride;
+			this->attributes.push_back(attribute);
+		}
 
-	void intVertex(GLint index, GLint size, GLsizei stride, void* offset, GLuint divisor) {
-		glVertexAttribIPointer(
-		    index,
-		    size,
-		    GL_INT,
-		    stride,
-		    offset
-		);
-		glVertexAttribDivisor(index, divisor);
-		glEnableVertexAttribArray(index);
+		this->stride += stride_;
+
+		return *this;
 	}
 
-	void int16Vertex(GLint index, GLint size, GLsizei stride, void* offset, GLuint divisor) {
-		glVertexAttribIPointer(
-		    index,
-		    size,
-		    GL_SHORT,
-		    stride,
-		    offset
-		);
-		glVertexAttribDivisor(index, divisor);
-		glEnableVertexAttribArray(index);
+	GLuint setAttributePointer(GLuint index, VertexAttribute const& attribute, GLsizei stride) {
+		auto format = getAttributeFormat(attribute.dataType);
+
+		if (!format.has_value()) {
+			tassert(0);
+			return index;
+		}
+
+		for (integer_t column = 0; column < format->columns; column++, index++) {
+			auto offset = reinterpret_cast<void*>(attribute.offset + column * format->columnStride);
+
+			if (format->integer) {
+				glVertexAttribIPointer(index, format->size, format->type, stride, offset);
+			}
+			else {
+				glVertexAttribPointer(index, format->size, format->type, format->normalized, stride, offset);
+			}
+			glVertexAttribDivisor(index, attribute.divisor);
+			glEnableVertexAttribArray(index);
+		}
+
+		return index;
 	}
 
 	void Descriptor::finalize(OpenglVBO& VBO) {
 		this->VAO.bind();
 		VBO.bind(BufferTarget::Type::ARRAY_BUFFER);
 
-		GLint& index = this->VAO.attributeCount;
 		for (auto const& attribute : this->attributes) {
-			switch (attribute.dataType) {
-				case DataType::f32:
-					floatVertex(index++, 1, this->stride, (void*)attribute.offset, attribute.divisor);
-					break;
-				case DataType::vec2:
-					floatVertex(index++, 2, this->stride, (void*)attribute.offset, attribute.divisor);
-					break;
-				case DataType::vec3:
-					floatVertex(index++, 3, this->stride, (void*)attribute.offset, attribute.divisor);
-					break;
-				case DataType::vec4:
-					floatVertex(index++, 4, this->stride, (void*)attribute.offset, attribute.divisor);
-					break;
-				case DataType::mat2:
-					floatVertex(index++, 2, this->stride, (void*)attribute.offset, attribute.divisor);
-					floatVertex(index++, 2, this->stride, (void*)(attribute.offset + 2 * sizeof(float)), attribute.divisor);
-					break;
-				case DataType::mat3:
-					floatVertex(index++, 3, this->stride, (void*)attribute.offset, attribute.divisor);
-					floatVertex(index++, 3, this->stride, (void*)(attribute.offset + 3 * sizeof(float)), attribute.divisor);
-					floatVertex(index++, 3, this->stride, (void*)(attribute.offset + 9 * sizeof(float)), attribute.divisor);
-					break;
-				case DataType::mat4:
-					floatVertex(index++, 4, this->stride, (void*)attribute.offset, attribute.divisor);
-					floatVertex(index++, 4, this->stride, (void*)(attribute.offset + 4 * sizeof(float)), attribute.divisor);
-					floatVertex(index++, 4, this->stride, (void*)(attribute.offset + 8 * sizeof(float)), attribute.divisor);
-					floatVertex(index++, 4, this->stride, (void*)(attribute.offset + 12 * sizeof(float)), attribute.divisor);
-					break;
-				case DataType::i32:
-					intVertex(index++, 1, this->stride, (void*)attribute.offset, attribute.divisor);
-					break;
-				case DataType::i16vec2:
-					int16Vertex(index++, 2, this->stride, (void*)attribute.offset, attribute.divisor);
-					break;
-				case DataType::ivec2:
-					intVertex(index++, 2, this->stride, (void*)attribute.offset, attribute.divisor);
-					break;
-				case DataType::ivec3:
-					intVertex(index++, 3, this->stride, (void*)attribute.offset, attribute.divisor);
-					break;
-				case DataType::ivec4:
-					intVertex(index++, 4, this->stride, (void*)attribute.offset, attribute.divisor);
-					break;
-				case DataType::coloru32:
-				{
-					auto i = index++;
-					glVertexAttribPointer(
-					    i,
-					    static_cast<GLint>(4),
-					    GL_UNSIGNED_BYTE,
-					    GL_TRUE,
-					    this->stride,
-					    (void*)attribute.offset
-					);
-					glVertexAttribDivisor(i, attribute.divisor);
-					glEnableVertexAttribArray(i);
-				} break;
-				default:
-				case DataType::u32:
-				case DataType::uvec2:
-				case DataType::uvec3:
-				case DataType::uvec4:
-				case DataType::mat2x3:
-				case DataType::mat3x2:
-				case DataType::mat2x4:
-				case DataType::mat4x2:
-				case DataType::mat3x4:
-				case DataType::mat4x3:
-					tassert(0);
-					break;
-			}
+			this->VAO.attributeCount = static_cast<GLint>(setAttributePointer(static_cast<GLuint>(this->VAO.attributeCount), attribute, this->stride));
 		}
 	}
 
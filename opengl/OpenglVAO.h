@@ -1,10 +1,12 @@
 #pragma once
 
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include <tepp/optional_ref.h>
+#include <tepp/span.h>
 
 #include <wrangled_gl/wrangled_gl.h>
 
@@ -21,8 +23,123 @@ namespace render::opengl
 		DataType dataType{};
 		integer_t offset{};
 		GLuint divisor{};
+
+		bool operator==(VertexAttribute const& other) const = default;
+	};
+
+	// How a DataType is laid out as vertex attributes, matrices take one attribute per column.
+	struct AttributeFormat
+	{
+		GLint size{};
+		GLenum type{};
+		GLboolean normalized = GL_FALSE;
+		bool integer = false;
+
+		integer_t columns = 1;
+		integer_t columnStride = 0;
 	};
 
+	constexpr std::optional<AttributeFormat> getAttributeFormat(DataType dataType) {
+		switch (dataType) {
+			case DataType::f32:
+				return AttributeFormat{ .size = 1, .type = GL_FLOAT };
+			case DataType::vec2:
+				return AttributeFormat{ .size = 2, .type = GL_FLOAT };
+			case DataType::vec3:
+				return AttributeFormat{ .size = 3, .type = GL_FLOAT };
+			case DataType::vec4:
+				return AttributeFormat{ .size = 4, .type = GL_FLOAT };
+			case DataType::mat2:
+				return AttributeFormat{ .size = 2, .type = GL_FLOAT, .columns = 2, .columnStride = 2 * sizeof(float) };
+			case DataType::mat3:
+				return AttributeFormat{ .size = 3, .type = GL_FLOAT, .columns = 3, .columnStride = 3 * sizeof(float) };
+			case DataType::mat4:
+				return AttributeFormat{ .size = 4, .type = GL_FLOAT, .columns = 4, .columnStride = 4 * sizeof(float) };
+			case DataType::mat2x3:
+				return AttributeFormat{ .size = 3, .type = GL_FLOAT, .columns = 2, .columnStride = 3 * sizeof(float) };
+			case DataType::mat3x2:
+				return AttributeFormat{ .size = 2, .type = GL_FLOAT, .columns = 3, .columnStride = 2 * sizeof(float) };
+			case DataType::mat2x4:
+				return AttributeFormat{ .size = 4, .type = GL_FLOAT, .columns = 2, .columnStride = 4 * sizeof(float) };
+			case DataType::mat4x2:
+				return AttributeFormat{ .size = 2, .type = GL_FLOAT, .columns = 4, .columnStride = 2 * sizeof(float) };
+			case DataType::mat3x4:
+				return AttributeFormat{ .size = 4, .type = GL_FLOAT, .columns = 3, .columnStride = 4 * sizeof(float) };
+			case DataType::mat4x3:
+				return AttributeFormat{ .size = 3, .type = GL_FLOAT, .columns = 4, .columnStride = 3 * sizeof(float) };
+			case DataType::i32:
+				return AttributeFormat{ .size = 1, .type = GL_INT, .integer = true };
+			case DataType::i16vec2:
+				return AttributeFormat{ .size = 2, .type = GL_SHORT, .integer = true };
+			case DataType::ivec2:
+				return AttributeFormat{ .size = 2, .type = GL_INT, .integer = true };
+			case DataType::ivec3:
+				return AttributeFormat{ .size = 3, .type = GL_INT, .integer = true };
+			case DataType::ivec4:
+				return AttributeFormat{ .size = 4, .type = GL_INT, .integer = true };
+			case DataType::u32:
+				return AttributeFormat{ .size = 1, .type = GL_UNSIGNED_INT, .integer = true };
+			case DataType::uvec2:
+				return AttributeFormat{ .size = 2, .type = GL_UNSIGNED_INT, .integer = true };
+			case DataType::uvec3:
+				return AttributeFormat{ .size = 3, .type = GL_UNSIGNED_INT, .integer = true };
+			case DataType::uvec4:
+				return AttributeFormat{ .size = 4, .type = GL_UNSIGNED_INT, .integer = true };
+			case DataType::coloru32:
+				return AttributeFormat{ .size = 4, .type = GL_UNSIGNED_BYTE, .normalized = GL_TRUE };
+			case DataType::f16vec2:
+				return AttributeFormat{ .size = 2, .type = GL_HALF_FLOAT };
+			case DataType::f16vec4:
+				return AttributeFormat{ .size = 4, .type = GL_HALF_FLOAT };
+			case DataType::snorm16vec2:
+				return AttributeFormat{ .size = 2, .type = GL_SHORT, .normalized = GL_TRUE };
+			case DataType::snorm16vec4:
+				return AttributeFormat{ .size = 4, .type = GL_SHORT, .normalized = GL_TRUE };
+			case DataType::unorm16vec2:
+				return AttributeFormat{ .size = 2, .type = GL_UNSIGNED_SHORT, .normalized = GL_TRUE };
+			case DataType::unorm16vec4:
+				return AttributeFormat{ .size = 4, .type = GL_UNSIGNED_SHORT, .normalized = GL_TRUE };
+			case DataType::snorm2_10_10_10:
+				return AttributeFormat{ .size = 4, .type = GL_INT_2_10_10_10_REV, .normalized = GL_TRUE };
+			default:
+				return std::nullopt;
+		}
+	}
+
+	namespace impl
+	{
+		// The columns of a matrix attribute have to cover its DataType exactly, a wrong columnStride reads
+		// the later columns from the wrong offsets.
+		constexpr bool hasMatrixLayout(DataType dataType) {
+			auto format = getAttributeFormat(dataType);
+			return format.has_value() && format->columns > 1 && format->columns * format->columnStride == dataTypeByteSize[dataType];
+		}
+
+		constexpr bool hasAllAttributeFormats() {
+			for (int32_t i = 0; i < static_cast<int32_t>(DataType::MAX); i++) {
+				if (!getAttributeFormat(static_cast<DataType>(i)).has_value()) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	static_assert(impl::hasMatrixLayout(DataType::mat2));
+	static_assert(impl::hasMatrixLayout(DataType::mat3));
+	static_assert(impl::hasMatrixLayout(DataType::mat4));
+	static_assert(impl::hasMatrixLayout(DataType::mat2x3));
+	static_assert(impl::hasMatrixLayout(DataType::mat3x2));
+	static_assert(impl::hasMatrixLayout(DataType::mat2x4));
+	static_assert(impl::hasMatrixLayout(DataType::mat4x2));
+	static_assert(impl::hasMatrixLayout(DataType::mat3x4));
+	static_assert(impl::hasMatrixLayout(DataType::mat4x3));
+	static_assert(impl::hasAllAttributeFormats());
+
+	// Specifies the pointers of attribute for the buffer bound to GL_ARRAY_BUFFER, starting at index.
+	// Returns the index after the last column.
+	GLuint setAttributePointer(GLuint index, VertexAttribute const& attribute, GLsizei stride);
+
 	struct Descriptor
 	{
 		OpenglVAO& VAO;
@@ -37,6 +154,9 @@ namespace render::opengl
 		    std::optional<GLuint> divisor = std::nullopt
 		);
 
+		// Appends attributes laid out relative to the start of one element of size stride, see StructLayout.
+		Descriptor& add(te::span<VertexAttribute const> attributes, GLsizei stride);
+
 		GLuint getDivisor() const;
 
 		void finalize(OpenglVBO& VBO);
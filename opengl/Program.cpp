@@ -3,7 +3,21 @@
 #include "render/opengl/OpenglContext.h"
 #include "render/opengl/Uniforms.h"
 
+#include <algorithm>
+#include <bit>
 #include <fstream>
+#include <numeric>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace render::opengl
 {
@@ -15,6 +29,98 @@ namespace render::opengl
 		return this->data;
 	}
 
+	te::span<char const> MappedData::get() const {
+		return this->data;
+	}
+
+	std::unique_ptr<MappedData> MappedData::map(std::filesystem::path const& path) {
+		auto result = std::make_unique<MappedData>();
+
+#ifdef _WIN32
+		result->file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (result->file == INVALID_HANDLE_VALUE) {
+			result->file = nullptr;
+			return nullptr;
+		}
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(result->file, &fileSize)) {
+			return nullptr;
+		}
+
+		// Empty files can not be mapped, they are returned as empty data.
+		if (fileSize.QuadPart == 0) {
+			return result;
+		}
+
+		result->mapping = CreateFileMappingW(result->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (result->mapping == nullptr) {
+			return nullptr;
+		}
+
+		auto ptr = MapViewOfFile(result->mapping, FILE_MAP_READ, 0, 0, 0);
+
+		if (ptr == nullptr) {
+			return nullptr;
+		}
+
+		result->data = te::span<char const>(static_cast<char const*>(ptr), static_cast<std::size_t>(fileSize.QuadPart));
+#else
+		auto file = open(path.c_str(), O_RDONLY);
+
+		if (file == -1) {
+			return nullptr;
+		}
+
+		struct stat fileStat{};
+		if (fstat(file, &fileStat) != 0) {
+			close(file);
+			return nullptr;
+		}
+
+		// Empty files can not be mapped, they are returned as empty data.
+		if (fileStat.st_size == 0) {
+			close(file);
+			return result;
+		}
+
+		auto ptr = mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+
+		if (ptr == MAP_FAILED) {
+			return nullptr;
+		}
+
+		result->data = te::span<char const>(static_cast<char const*>(ptr), static_cast<std::size_t>(fileStat.st_size));
+#endif
+
+		return result;
+	}
+
+	MappedData::~MappedData() {
+#ifdef _WIN32
+		if (this->data.data() != nullptr) {
+			UnmapViewOfFile(this->data.data());
+		}
+		if (this->mapping != nullptr) {
+			CloseHandle(this->mapping);
+		}
+		if (this->file != nullptr) {
+			CloseHandle(this->file);
+		}
+#else
+		if (this->data.data() != nullptr) {
+			munmap(const_cast<char*>(this->data.data()), this->data.size());
+		}
+#endif
+	}
+
+	std::optional<std::filesystem::path> DataSource::getPath() const {
+		return std::nullopt;
+	}
+
 	FileSource::FileSource(std::filesystem::path path_)
 	    : path(path_) {
 	}
@@ -46,10 +152,42 @@ namespace render::opengl
 		return result;
 	}
 
+	std::optional<std::filesystem::path> FileSource::getPath() const {
+		return this->path;
+	}
+
 	std::unique_ptr<DataSource> FileSource::make(std::filesystem::path const& path) {
 		return std::make_unique<FileSource>(path);
 	}
 
+	MappedFileSource::MappedFileSource(std::filesystem::path path_)
+	    : path(path_) {
+	}
+
+	std::optional<DataSourceType> MappedFileSource::data() const {
+		auto mappedData = MappedData::map(this->path);
+
+		if (mappedData == nullptr) {
+			return std::nullopt;
+		}
+
+		return mappedData;
+	}
+
+	std::unique_ptr<DataSource> MappedFileSource::copy() const {
+		auto result = std::make_unique<MappedFileSource>();
+		result->path = this->path;
+		return result;
+	}
+
+	std::optional<std::filesystem::path> MappedFileSource::getPath() const {
+		return this->path;
+	}
+
+	std::unique_ptr<DataSource> MappedFileSource::make(std::filesystem::path const& path) {
+		return std::make_unique<MappedFileSource>(path);
+	}
+
 	std::optional<DataSourceType> StaticSource::data() const {
 		auto referenceData = std::make_unique<ReferenceData>();
 		referenceData->data = this->staticData.data;
@@ -96,15 +234,102 @@ namespace render::opengl
 				return left->location < right->location;
 			});
 			this->sortedUniforms = true;
+
+			this->dirtyUniforms.assign((this->uniformList.size() + 63) / 64, 0);
+
+			for (integer_t i = 0; i < isize(this->uniformList); i++) {
+				auto uniform = this->uniformList[i];
+				uniform->sortedIndex = i;
+
+				if (uniform->dirty) {
+					this->dirtyUniforms[i / 64] |= uint64_t(1) << (i % 64);
+				}
+			}
 		}
 
 		return this->uniformList;
 	}
 
+	void Program::markDirty(UniformBase& uniform) {
+		if (!uniform.dirty) {
+			uniform.dirty = true;
+			this->hasDirtyUniforms = true;
+
+			if (this->sortedUniforms && uniform.sortedIndex >= 0) {
+				this->dirtyUniforms[uniform.sortedIndex / 64] |= uint64_t(1) << (uniform.sortedIndex % 64);
+			}
+		}
+
+		if (this->openglContext.usedProgram == this->ID) {
+			this->flushUniforms();
+		}
+	}
+
+	void Program::flushUniforms() {
+		if (!this->hasDirtyUniforms) {
+			return;
+		}
+
+		tassert(this->openglContext.usedProgram == this->ID);
+
+		auto uniforms = this->getUniformsSorted();
+
+		for (std::size_t word = 0; word < this->dirtyUniforms.size(); word++) {
+			for (auto bits = this->dirtyUniforms[word]; bits != 0; bits &= bits - 1) {
+				auto uniform = uniforms[word * 64 + static_cast<std::size_t>(std::countr_zero(bits))];
+
+				uniform->upload();
+				uniform->dirty = false;
+			}
+
+			this->dirtyUniforms[word] = 0;
+		}
+
+		this->hasDirtyUniforms = false;
+	}
+
 	void Program::use() {
 		this->openglContext.use(*this);
 	}
 
+	namespace
+	{
+		bool applyBlockBinding(Program& program, std::string_view name, GLuint binding) {
+			auto it = std::ranges::find(program.reflection.blocks, name, &UniformBlockInfo::name);
+
+			if (it == program.reflection.blocks.end()) {
+				return false;
+			}
+
+			glUniformBlockBinding(program.ID.data, it->index, binding);
+			it->binding = static_cast<GLint>(binding);
+
+			return true;
+		}
+	}
+
+	bool Program::setBlockBinding(std::string_view name_, integer_t binding) {
+		auto name = std::string(name_);
+		this->blockBindings[name] = static_cast<GLuint>(binding);
+
+		return applyBlockBinding(*this, name, static_cast<GLuint>(binding));
+	}
+
+	void Program::refreshUniforms() {
+		this->sortedUniforms = false;
+
+		for (auto uniform : this->uniformList) {
+			uniform->refresh();
+		}
+
+		// Block indices can change with a relink, the bindings are resolved by name.
+		for (auto const& [name, binding] : this->blockBindings) {
+			if (!applyBlockBinding(*this, name, binding)) {
+				this->openglContext.logWarning("Uniform block {} is no longer active after relinking.\n", name);
+			}
+		}
+	}
+
 	Program::Program(OpenglContext& openglContext_)
 	    : openglContext(openglContext_) {
 	}
@@ -124,8 +349,11 @@ namespace render::opengl
 		other.name = {};
 
 		this->vertexInfos = std::move(other.vertexInfos);
+		this->reflection = std::move(other.reflection);
+		this->blockBindings = std::move(other.blockBindings);
 
 		this->shaderSourceGenerators = std::move(other.shaderSourceGenerators);
+		this->shaderSources = std::move(other.shaderSources);
 
 		this->openglContext.registerProgram(*this);
 	}
@@ -150,8 +378,10 @@ namespace render::opengl
 		other.name = {};
 
 		this->vertexInfos = std::move(other.vertexInfos);
+		this->reflection = std::move(other.reflection);
 
 		this->shaderSourceGenerators = std::move(other.shaderSourceGenerators);
+		this->shaderSources = std::move(other.shaderSources);
 
 		if (description.has_value()) {
 			this->openglContext.registerProgram(*this, description.value());
@@ -170,6 +400,24 @@ namespace render::opengl
 	}
 
 	std::optional<Program> Program::load(OpenglContext& openglContext, te::span<char const> vertexDataSpan, te::span<char const> fragmentDataSpan) {
+		auto& programBinaryCache = openglContext.programBinaryCache;
+
+		std::optional<uint64_t> cacheKey{};
+
+		if (programBinaryCache.has_value() && programBinaryCache->supported()) {
+			cacheKey = programBinaryCache->getKey(
+			    openglContext,
+			    std::string_view(vertexDataSpan.data(), vertexDataSpan.size()),
+			    std::string_view(fragmentDataSpan.data(), fragmentDataSpan.size())
+			);
+
+			if (auto ID = programBinaryCache->restore(openglContext, cacheKey.value())) {
+				auto result = Program(openglContext, ID.value());
+				result.reflect();
+				return result;
+			}
+		}
+
 		auto vertexShader = Shader::makeVertexShader();
 		auto fragmentShader = Shader::makeFragmentShader();
 
@@ -219,6 +467,11 @@ namespace render::opengl
 		GLuint ProgramID = glCreateProgram();
 		glAttachShader(ProgramID, vertexShader.ID);
 		glAttachShader(ProgramID, fragmentShader.ID);
+
+		if (cacheKey.has_value()) {
+			glProgramParameteri(ProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
 		glLinkProgram(ProgramID);
 
 		// Check the program
@@ -236,13 +489,160 @@ namespace render::opengl
 
 		openglContext.logInfo("Program ID: {}\n", ProgramID);
 
+		if (cacheKey.has_value()) {
+			programBinaryCache->store(openglContext, cacheKey.value(), ProgramID);
+		}
+
 		auto result = Program(openglContext, ProgramID);
+		result.reflect();
+
+		return result;
+	}
+
+	UniformInfo const* ProgramReflection::findUniform(std::string_view name) const {
+		auto it = this->uniformIndices.find(name);
+
+		if (it == this->uniformIndices.end()) {
+			return nullptr;
+		}
+
+		return &this->uniforms[it->second];
+	}
+
+	UniformBlockInfo const* ProgramReflection::findBlock(std::string_view name) const {
+		auto it = std::ranges::find(this->blocks, name, &UniformBlockInfo::name);
+
+		if (it == this->blocks.end()) {
+			return nullptr;
+		}
+
+		return &*it;
+	}
+
+	bool isSamplerType(GLenum type) {
+		switch (type) {
+			case GL_SAMPLER_2D:
+			case GL_SAMPLER_3D:
+			case GL_SAMPLER_CUBE:
+			case GL_SAMPLER_2D_SHADOW:
+			case GL_SAMPLER_2D_ARRAY:
+			case GL_SAMPLER_2D_ARRAY_SHADOW:
+			case GL_SAMPLER_CUBE_SHADOW:
+			case GL_SAMPLER_BUFFER:
+			case GL_SAMPLER_2D_MULTISAMPLE:
+			case GL_INT_SAMPLER_2D:
+			case GL_INT_SAMPLER_3D:
+			case GL_INT_SAMPLER_CUBE:
+			case GL_INT_SAMPLER_2D_ARRAY:
+			case GL_INT_SAMPLER_BUFFER:
+			case GL_UNSIGNED_INT_SAMPLER_2D:
+			case GL_UNSIGNED_INT_SAMPLER_3D:
+			case GL_UNSIGNED_INT_SAMPLER_CUBE:
+			case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+			case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	void Program::reflect() {
+		this->reflectAttributes();
+		this->reflectUniforms();
+	}
+
+	void Program::reflectUniforms() {
+		auto& reflection = this->reflection;
+		reflection = {};
+
+		GLint uniformCount = 0;
+		glGetProgramiv(this->ID.data, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+		GLint nameLength = 0;
+		glGetProgramiv(this->ID.data, GL_ACTIVE_UNIFORM_MAX_LENGTH, &nameLength);
+
+		std::string nameBuffer{};
+		nameBuffer.resize(std::max(1, nameLength));
+
+		std::vector<GLuint> indices(static_cast<std::size_t>(uniformCount));
+		std::iota(indices.begin(), indices.end(), 0u);
+
+		auto getUniforms = [&](GLenum parameter) {
+			std::vector<GLint> result(indices.size());
+			if (!indices.empty()) {
+				glGetActiveUniformsiv(this->ID.data, static_cast<GLsizei>(indices.size()), indices.data(), parameter, result.data());
+			}
+			return result;
+		};
+
+		auto blockIndices = getUniforms(GL_UNIFORM_BLOCK_INDEX);
+		auto offsets = getUniforms(GL_UNIFORM_OFFSET);
+		auto arrayStrides = getUniforms(GL_UNIFORM_ARRAY_STRIDE);
+		auto matrixStrides = getUniforms(GL_UNIFORM_MATRIX_STRIDE);
+
+		reflection.uniforms.reserve(indices.size());
+
+		for (auto i : indices) {
+			GLsizei actualNameLength = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(this->ID.data, i, static_cast<GLsizei>(nameBuffer.size()), &actualNameLength, &size, &type, nameBuffer.data());
+
+			auto& info = reflection.uniforms.emplace_back();
+			info.name = std::string_view(nameBuffer.data(), actualNameLength);
+			info.type = type;
+			info.size = size;
+			info.blockIndex = blockIndices[i];
+
+			if (info.blockIndex == -1) {
+				info.location = glGetUniformLocation(this->ID.data, info.name.c_str());
+			}
+			else {
+				info.offset = offsets[i];
+				info.arrayStride = arrayStrides[i];
+				info.matrixStride = matrixStrides[i];
+			}
+
+			auto index = isize(reflection.uniforms) - 1;
+			reflection.uniformIndices[info.name] = index;
+
+			if (info.name.ends_with("[0]")) {
+				reflection.uniformIndices[info.name.substr(0, info.name.size() - 3)] = index;
+			}
+
+			if (isSamplerType(type)) {
+				reflection.samplers.push_back(index);
+			}
+		}
+
+		GLint blockCount = 0;
+		glGetProgramiv(this->ID.data, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+
+		GLint blockNameLength = 0;
+		glGetProgramiv(this->ID.data, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &blockNameLength);
+
+		nameBuffer.resize(std::max(1, blockNameLength));
+
+		for (GLuint i = 0; i < static_cast<GLuint>(blockCount); i++) {
+			GLsizei actualNameLength = 0;
+			glGetActiveUniformBlockName(this->ID.data, i, static_cast<GLsizei>(nameBuffer.size()), &actualNameLength, nameBuffer.data());
+
+			auto& block = reflection.blocks.emplace_back();
+			block.name = std::string_view(nameBuffer.data(), actualNameLength);
+			block.index = i;
+			glGetActiveUniformBlockiv(this->ID.data, i, GL_UNIFORM_BLOCK_DATA_SIZE, &block.dataSize);
+			glGetActiveUniformBlockiv(this->ID.data, i, GL_UNIFORM_BLOCK_BINDING, &block.binding);
+		}
+	}
+
+	void Program::reflectAttributes() {
+		this->vertexInfos.clear();
 
 		GLint vertexCount = 0;
-		glGetProgramiv(result.ID.data, GL_ACTIVE_ATTRIBUTES, &vertexCount);
+		glGetProgramiv(this->ID.data, GL_ACTIVE_ATTRIBUTES, &vertexCount);
 
 		GLint nameLength = 0;
-		glGetProgramiv(result.ID.data, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &nameLength);
+		glGetProgramiv(this->ID.data, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &nameLength);
 
 		std::string vertexNameBuffer{};
 		vertexNameBuffer.resize(nameLength);
@@ -251,11 +651,11 @@ namespace render::opengl
 			GLsizei actualNameLength = 0;
 			GLint size = 0;
 			GLenum type = 0;
-			glGetActiveAttrib(result.ID.data, static_cast<GLuint>(i), nameLength, &actualNameLength, &size, &type, vertexNameBuffer.data());
+			glGetActiveAttrib(this->ID.data, static_cast<GLuint>(i), nameLength, &actualNameLength, &size, &type, vertexNameBuffer.data());
 
 			std::string_view vertexName = std::string_view(vertexNameBuffer.data(), actualNameLength);
 
-			auto& info = result.vertexInfos.emplace_back();
+			auto& info = this->vertexInfos.emplace_back();
 			info.index = i;
 			info.name = vertexName;
 #ifdef WRANGLE_GLESv3
@@ -301,8 +701,6 @@ namespace render::opengl
 				}
 			});
 		}
-
-		return result;
 	}
 
 	std::optional<Program> Program::load(
@@ -328,7 +726,24 @@ namespace render::opengl
 		auto vertexDataSpan = vertexData.value()->get();
 		auto fragmentDataSpan = fragmentData.value()->get();
 
-		return Program::load(openglContext, vertexDataSpan, fragmentDataSpan);
+		auto program = Program::load(openglContext, vertexDataSpan, fragmentDataSpan);
+
+		if (program.has_value()) {
+			auto& description = openglContext.programRegistry.programs[program->ID.data];
+
+			for (auto const& source : { vertexSource.get(), fragmentSource.get() }) {
+				if (auto path = source->getPath()) {
+					description.sourcePaths.push_back(std::move(path.value()));
+				}
+			}
+
+			program->shaderSources = ShaderSources{
+				.vertexSource = std::move(vertexSource),
+				.fragmentSource = std::move(fragmentSource),
+			};
+		}
+
+		return program;
 	}
 
 	std::optional<Program> Program::load(OpenglContext& openglContext, BufferGenerator vertexSourceGenerator, BufferGenerator fragmentSourceGenerator) {
@@ -358,6 +773,15 @@ namespace render::opengl
 			if (newProgram.has_value()) {
 				newProgram->name = program.name;
 				program = std::move(newProgram.value());
+				program.refreshUniforms();
+			}
+		}
+		else if (program.shaderSources.has_value()) {
+			auto newProgram = Program::load(program.openglContext, program.shaderSources->vertexSource->copy(), program.shaderSources->fragmentSource->copy());
+			if (newProgram.has_value()) {
+				newProgram->name = program.name;
+				program = std::move(newProgram.value());
+				program.refreshUniforms();
 			}
 		}
 	}
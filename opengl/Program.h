@@ -6,6 +6,8 @@
 
 #include <wrangled_gl/wrangled_gl.h>
 
+#include <misc/Misc.h>
+
 #include "render/opengl/Qualifier.h"
 
 #include <tepp/cstring_view.h>
@@ -40,6 +42,28 @@ namespace render::opengl
 		virtual te::span<char const> get() const override;
 	};
 
+	// Read only view of a whole file mapped into memory, pages are loaded on first access. An empty file
+	// maps to an empty span.
+	struct MappedData : Data
+	{
+		te::span<char const> data{};
+
+		virtual te::span<char const> get() const override;
+
+		static std::unique_ptr<MappedData> map(std::filesystem::path const& path);
+
+		MappedData() = default;
+		~MappedData();
+
+		NO_COPY_MOVE(MappedData);
+
+	private:
+#ifdef _WIN32
+		void* file = nullptr;
+		void* mapping = nullptr;
+#endif
+	};
+
 	using DataSourceType = std::unique_ptr<Data>;
 
 	struct DataSource
@@ -47,6 +71,9 @@ namespace render::opengl
 		virtual std::optional<DataSourceType> data() const = 0;
 		virtual std::unique_ptr<DataSource> copy() const = 0;
 
+		// File backing the data, used to watch shader sources for changes.
+		virtual std::optional<std::filesystem::path> getPath() const;
+
 		DataSource() = default;
 		virtual ~DataSource() = default;
 	};
@@ -60,6 +87,20 @@ namespace render::opengl
 
 		std::optional<DataSourceType> data() const override;
 		std::unique_ptr<DataSource> copy() const override;
+		std::optional<std::filesystem::path> getPath() const override;
+		static std::unique_ptr<DataSource> make(std::filesystem::path const& path);
+	};
+
+	struct MappedFileSource : DataSource
+	{
+		std::filesystem::path path{};
+
+		MappedFileSource() = default;
+		MappedFileSource(std::filesystem::path path_);
+
+		std::optional<DataSourceType> data() const override;
+		std::unique_ptr<DataSource> copy() const override;
+		std::optional<std::filesystem::path> getPath() const override;
 		static std::unique_ptr<DataSource> make(std::filesystem::path const& path);
 	};
 
@@ -103,6 +144,12 @@ namespace render::opengl
 		BufferGenerator fragmentGenerator{};
 	};
 
+	struct ShaderSources
+	{
+		std::unique_ptr<DataSource> vertexSource{};
+		std::unique_ptr<DataSource> fragmentSource{};
+	};
+
 	struct UniformBase;
 
 	struct VertexInfo
@@ -112,6 +159,45 @@ namespace render::opengl
 		std::string type{};
 	};
 
+	struct UniformInfo
+	{
+		std::string name{};
+		GLint location = -1;
+		GLenum type{};
+		GLint size{};
+
+		// -1 for uniforms in the default block, offsets and strides are only valid inside blocks.
+		GLint blockIndex = -1;
+		GLint offset = -1;
+		GLint arrayStride = -1;
+		GLint matrixStride = -1;
+	};
+
+	struct UniformBlockInfo
+	{
+		std::string name{};
+		GLuint index{};
+		GLint dataSize{};
+		GLint binding{};
+	};
+
+	// Active uniforms of a linked program, arrays can be found both as "name" and "name[0]".
+	struct ProgramReflection
+	{
+		std::vector<UniformInfo> uniforms{};
+		te::string_key_unordered_map<integer_t> uniformIndices{};
+
+		std::vector<UniformBlockInfo> blocks{};
+
+		// Indices into uniforms.
+		std::vector<integer_t> samplers{};
+
+		UniformInfo const* findUniform(std::string_view name) const;
+		UniformBlockInfo const* findBlock(std::string_view name) const;
+	};
+
+	bool isSamplerType(GLenum type);
+
 	struct Program
 	{
 		te::cstring_view name{};
@@ -119,12 +205,22 @@ namespace render::opengl
 		Qualified<GLuint> ID{};
 
 		std::optional<BufferGenerators> shaderSourceGenerators{};
+		std::optional<ShaderSources> shaderSources{};
 
 		te::string_key_unordered_map<UniformBase*> uniformReferences{};
 		mutable bool sortedUniforms = true;
 		mutable std::vector<UniformBase*> uniformList{};
 
+		// One bit per entry of getUniformsSorted, set for uniforms whose value has not been uploaded yet.
+		mutable std::vector<uint64_t> dirtyUniforms{};
+		bool hasDirtyUniforms = false;
+
 		std::vector<VertexInfo> vertexInfos{};
+		ProgramReflection reflection{};
+
+		// Uniform block bindings by block name, they stay with the Program when a relinked program is
+		// moved into it and are applied again by refreshUniforms.
+		te::string_key_unordered_map<GLuint> blockBindings{};
 
 		int32_t samplerCount = 0;
 
@@ -133,8 +229,23 @@ namespace render::opengl
 		void registerUniform(UniformBase& uniform);
 		te::span<UniformBase*> getUniformsSorted() const;
 
+		// Uploads happen right away when the program is in use, otherwise on the next use().
+		void markDirty(UniformBase& uniform);
+		void flushUniforms();
+
 		void use();
 
+		// Fills vertexInfos and reflection from the linked program.
+		void reflect();
+		void reflectAttributes();
+		void reflectUniforms();
+
+		// Records the binding of the named uniform block and applies it, returns false when the block is not active.
+		bool setBlockBinding(std::string_view name, integer_t binding);
+
+		// Looks up the locations of all registered uniforms again and reapplies their values and block bindings.
+		void refreshUniforms();
+
 		Program(OpenglContext& openglContext);
 		Program(OpenglContext& openglContext, GLuint ID_);
 
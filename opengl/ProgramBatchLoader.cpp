@@ -0,0 +1,195 @@
+#include "render/opengl/ProgramBatchLoader.h"
+
+#include "render/opengl/OpenglContext.h"
+
+#include <limits>
+#include <string>
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace render::opengl
+{
+	namespace impl
+	{
+		struct ProgramBatchJob
+		{
+			Shader vertexShader{};
+			Shader fragmentShader{};
+			GLuint program = 0;
+
+			std::optional<uint64_t> cacheKey{};
+
+			std::promise<std::optional<Program>> promise{};
+		};
+	}
+
+	namespace
+	{
+		std::string getShaderLog(GLuint shader) {
+			GLint length = 0;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+
+			std::string result{};
+			if (length > 0) {
+				result.resize(length);
+				glGetShaderInfoLog(shader, length, nullptr, result.data());
+			}
+
+			return result;
+		}
+
+		std::string getProgramLog(GLuint program) {
+			GLint length = 0;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+
+			std::string result{};
+			if (length > 0) {
+				result.resize(length);
+				glGetProgramInfoLog(program, length, nullptr, result.data());
+			}
+
+			return result;
+		}
+
+		std::future<std::optional<Program>> makeFailed() {
+			std::promise<std::optional<Program>> promise{};
+			promise.set_value(std::nullopt);
+			return promise.get_future();
+		}
+	}
+
+	std::future<std::optional<Program>> ProgramBatchLoader::load(te::span<char const> vertexSource, te::span<char const> fragmentSource) {
+		if (vertexSource.size() > std::numeric_limits<GLint>::max() || fragmentSource.size() > std::numeric_limits<GLint>::max()) {
+			return makeFailed();
+		}
+
+		auto job = std::make_unique<impl::ProgramBatchJob>();
+		auto result = job->promise.get_future();
+
+		auto vertexView = std::string_view(vertexSource.data(), vertexSource.size());
+		auto fragmentView = std::string_view(fragmentSource.data(), fragmentSource.size());
+
+		auto& programBinaryCache = this->openglContext.programBinaryCache;
+
+		if (programBinaryCache.has_value() && programBinaryCache->supported()) {
+			job->cacheKey = programBinaryCache->getKey(this->openglContext, vertexView, fragmentView);
+
+			if (auto ID = programBinaryCache->restore(this->openglContext, job->cacheKey.value())) {
+				auto program = Program(this->openglContext, ID.value());
+				program.reflect();
+				job->promise.set_value(std::move(program));
+				return result;
+			}
+		}
+
+		job->vertexShader = Shader::makeVertexShader();
+		job->fragmentShader = Shader::makeFragmentShader();
+
+		this->openglContext.setShaderSource(job->vertexShader.ID, vertexView);
+		glCompileShader(job->vertexShader.ID);
+
+		this->openglContext.setShaderSource(job->fragmentShader.ID, fragmentView);
+		glCompileShader(job->fragmentShader.ID);
+
+		job->program = glCreateProgram();
+		glAttachShader(job->program, job->vertexShader.ID);
+		glAttachShader(job->program, job->fragmentShader.ID);
+
+		if (job->cacheKey.has_value()) {
+			glProgramParameteri(job->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
+		glLinkProgram(job->program);
+
+		this->jobs.push_back(std::move(job));
+
+		return result;
+	}
+
+	std::future<std::optional<Program>> ProgramBatchLoader::load(std::unique_ptr<DataSource> vertexSource, std::unique_ptr<DataSource> fragmentSource) {
+		auto vertexData = vertexSource->data();
+		auto fragmentData = fragmentSource->data();
+
+		if (!vertexData.has_value() || !fragmentData.has_value()) {
+			this->openglContext.logError("Failed to read shader sources\n");
+			return makeFailed();
+		}
+
+		return this->load(vertexData.value()->get(), fragmentData.value()->get());
+	}
+
+	void ProgramBatchLoader::update() {
+		std::erase_if(this->jobs, [this](auto& job) {
+			if (this->parallelCompile) {
+				GLint completed = GL_FALSE;
+				glGetProgramiv(job->program, GL_COMPLETION_STATUS_KHR, &completed);
+
+				if (completed == GL_FALSE) {
+					return false;
+				}
+			}
+
+			this->resolve(*job);
+			return true;
+		});
+	}
+
+	void ProgramBatchLoader::finish() {
+		for (auto& job : this->jobs) {
+			this->resolve(*job);
+		}
+
+		this->jobs.clear();
+	}
+
+	bool ProgramBatchLoader::done() const {
+		return this->jobs.empty();
+	}
+
+	ProgramBatchLoader::ProgramBatchLoader(OpenglContext& openglContext_)
+	    : openglContext(openglContext_) {
+		this->parallelCompile = this->openglContext.hasExtension("GL_KHR_parallel_shader_compile")
+		                        || this->openglContext.hasExtension("GL_ARB_parallel_shader_compile");
+	}
+
+	ProgramBatchLoader::~ProgramBatchLoader() {
+		this->finish();
+	}
+
+	void ProgramBatchLoader::resolve(impl::ProgramBatchJob& job) {
+		GLint status = GL_FALSE;
+
+		glGetShaderiv(job.vertexShader.ID, GL_COMPILE_STATUS, &status);
+		if (status == GL_FALSE) {
+			this->openglContext.logError("Vertex shader error:\n{}\n", getShaderLog(job.vertexShader.ID));
+		}
+
+		glGetShaderiv(job.fragmentShader.ID, GL_COMPILE_STATUS, &status);
+		if (status == GL_FALSE) {
+			this->openglContext.logError("Fragment shader error:\n{}\n", getShaderLog(job.fragmentShader.ID));
+		}
+
+		glGetProgramiv(job.program, GL_LINK_STATUS, &status);
+		if (status == GL_FALSE) {
+			this->openglContext.logError("Program error:\n{}\n", getProgramLog(job.program));
+			glDeleteProgram(job.program);
+			job.promise.set_value(std::nullopt);
+			return;
+		}
+
+		glDetachShader(job.program, job.vertexShader.ID);
+		glDetachShader(job.program, job.fragmentShader.ID);
+
+		this->openglContext.logInfo("Program ID: {}\n", job.program);
+
+		if (job.cacheKey.has_value()) {
+			this->openglContext.programBinaryCache->store(this->openglContext, job.cacheKey.value(), job.program);
+		}
+
+		auto program = Program(this->openglContext, job.program);
+		program.reflect();
+		job.promise.set_value(std::move(program));
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <misc/Misc.h>
+
+#include <tepp/span.h>
+
+#include "render/opengl/Program.h"
+
+namespace render::opengl
+{
+	namespace impl
+	{
+		struct ProgramBatchJob;
+	}
+
+	// Submits every compile and link up front and only queries their results once the driver reports
+	// completion through KHR_parallel_shader_compile, so drivers can compile the whole batch on their own threads.
+	// Without the extension the results are queried in update() as well, still after everything has been submitted.
+	struct ProgramBatchLoader
+	{
+		OpenglContext& openglContext;
+
+		std::future<std::optional<Program>> load(te::span<char const> vertexSource, te::span<char const> fragmentSource);
+		std::future<std::optional<Program>> load(std::unique_ptr<DataSource> vertexSource, std::unique_ptr<DataSource> fragmentSource);
+
+		// Call on the thread owning the context, resolves the futures of programs that finished compiling.
+		void update();
+
+		// Resolves all outstanding futures, blocking on the driver where needed.
+		void finish();
+
+		bool done() const;
+
+		ProgramBatchLoader(OpenglContext& openglContext);
+		~ProgramBatchLoader();
+
+		NO_COPY_MOVE(ProgramBatchLoader);
+
+	private:
+		bool parallelCompile = false;
+		std::vector<std::unique_ptr<impl::ProgramBatchJob>> jobs{};
+
+		void resolve(impl::ProgramBatchJob& job);
+	};
+}
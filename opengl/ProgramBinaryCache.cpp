@@ -0,0 +1,183 @@
+#include "render/opengl/ProgramBinaryCache.h"
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include "render/Hash.h"
+#include "render/opengl/OpenglContext.h"
+
+namespace render::opengl
+{
+	namespace
+	{
+		struct EntryHeader
+		{
+			static constexpr uint32_t MAGIC = 0x42505243; // "CRPB"
+
+			uint32_t magic = MAGIC;
+			uint32_t binaryFormat{};
+			uint64_t key{};
+			uint64_t size{};
+		};
+
+		std::string_view getString(GLenum name) {
+			auto result = reinterpret_cast<char const*>(glGetString(name));
+
+			if (result == nullptr) {
+				return {};
+			}
+
+			return result;
+		}
+	}
+
+	uint64_t ProgramBinaryCache::getKey(OpenglContext& openglContext, std::string_view vertexSource, std::string_view fragmentSource) {
+		std::string_view prefix = openglContext.getShaderPrefix().getData();
+
+		auto result = this->getDriverHash();
+		result = hashBytes(prefix, result);
+		result = hashBytes(openglContext.trimShaderPrefix(vertexSource), result);
+		result = hashBytes(prefix, result);
+		result = hashBytes(openglContext.trimShaderPrefix(fragmentSource), result);
+
+		return result;
+	}
+
+	std::optional<GLuint> ProgramBinaryCache::restore(OpenglContext& openglContext, uint64_t key) {
+		if (!this->supported()) {
+			return std::nullopt;
+		}
+
+		auto path = this->getPath(key);
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+
+		if (!file.good()) {
+			return std::nullopt;
+		}
+
+		std::error_code error{};
+		auto fileSize = std::filesystem::file_size(path, error);
+
+		EntryHeader header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		if (!file.good() || header.magic != EntryHeader::MAGIC || header.key != key || header.size > std::numeric_limits<GLsizei>::max()) {
+			this->invalidate(key);
+			return std::nullopt;
+		}
+
+		// A truncated or padded entry is dropped before its size is trusted for the allocation.
+		if (error || fileSize < sizeof(header) || header.size != fileSize - sizeof(header)) {
+			this->invalidate(key);
+			return std::nullopt;
+		}
+
+		std::vector<char> binary(header.size);
+		file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+
+		if (!file.good()) {
+			this->invalidate(key);
+			return std::nullopt;
+		}
+
+		GLuint ID = glCreateProgram();
+		glProgramBinary(ID, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+
+		if (linked != GL_TRUE) {
+			openglContext.logInfo("Cached program binary {:016x} rejected by the driver, recompiling.\n", key);
+			glDeleteProgram(ID);
+			this->invalidate(key);
+			return std::nullopt;
+		}
+
+		return ID;
+	}
+
+	void ProgramBinaryCache::store(OpenglContext& openglContext, uint64_t key, GLuint program) {
+		if (!this->supported()) {
+			return;
+		}
+
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+		if (length <= 0) {
+			return;
+		}
+
+		std::vector<char> binary(static_cast<std::size_t>(length));
+		GLenum binaryFormat = 0;
+		GLsizei written = 0;
+		glGetProgramBinary(program, length, &written, &binaryFormat, binary.data());
+
+		if (written <= 0) {
+			return;
+		}
+
+		std::error_code error{};
+		std::filesystem::create_directories(this->directory, error);
+
+		auto path = this->getPath(key);
+		auto temporaryPath = path;
+		temporaryPath += ".tmp";
+
+		{
+			std::ofstream file(temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+			EntryHeader header{};
+			header.binaryFormat = binaryFormat;
+			header.key = key;
+			header.size = static_cast<uint64_t>(written);
+
+			file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+			file.write(binary.data(), written);
+
+			if (!file.good()) {
+				openglContext.logWarning("Failed to write program binary cache entry {}.\n", temporaryPath.string());
+				return;
+			}
+		}
+
+		std::filesystem::rename(temporaryPath, path, error);
+	}
+
+	void ProgramBinaryCache::invalidate(uint64_t key) {
+		std::error_code error{};
+		std::filesystem::remove(this->getPath(key), error);
+	}
+
+	bool ProgramBinaryCache::supported() {
+		if (!this->binaryFormatsSupported.has_value()) {
+			GLint formats = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+			this->binaryFormatsSupported = formats > 0;
+		}
+
+		return this->binaryFormatsSupported.value();
+	}
+
+	ProgramBinaryCache::ProgramBinaryCache(std::filesystem::path directory_)
+	    : directory(std::move(directory_)) {
+	}
+
+	uint64_t ProgramBinaryCache::getDriverHash() {
+		if (!this->driverHash.has_value()) {
+			auto result = hashBytes(getString(GL_VENDOR));
+			result = hashBytes(getString(GL_RENDERER), result);
+			result = hashBytes(getString(GL_VERSION), result);
+			this->driverHash = result;
+		}
+
+		return this->driverHash.value();
+	}
+
+	std::filesystem::path ProgramBinaryCache::getPath(uint64_t key) const {
+		return this->directory / std::format("{:016x}.bin", key);
+	}
+}
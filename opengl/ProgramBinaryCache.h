@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+#include <wrangled_gl/wrangled_gl.h>
+
+namespace render::opengl
+{
+	struct OpenglContext;
+
+	// On disk cache of linked program binaries, one file per program in directory. Keys include the
+	// driver vendor, renderer and version, so a driver update never restores a stale binary.
+	struct ProgramBinaryCache
+	{
+		std::filesystem::path directory{};
+
+		uint64_t getKey(OpenglContext& openglContext, std::string_view vertexSource, std::string_view fragmentSource);
+
+		// Returns a linked program, entries the driver rejects are removed.
+		std::optional<GLuint> restore(OpenglContext& openglContext, uint64_t key);
+		void store(OpenglContext& openglContext, uint64_t key, GLuint program);
+		void invalidate(uint64_t key);
+
+		// False when the driver supports no binary formats, the cache is a no-op then.
+		bool supported();
+
+		ProgramBinaryCache(std::filesystem::path directory);
+		~ProgramBinaryCache() = default;
+
+	private:
+		std::optional<uint64_t> driverHash{};
+		std::optional<bool> binaryFormatsSupported{};
+
+		uint64_t getDriverHash();
+		std::filesystem::path getPath(uint64_t key) const;
+	};
+}
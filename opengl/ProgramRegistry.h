@@ -2,7 +2,12 @@
 
 #include <wrangled_gl/wrangled_gl.h>
 
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <tepp/optional_ref.h>
 
@@ -10,11 +15,25 @@ namespace render::opengl
 {
 	struct Program;
 
+	struct ProgramVariantKey
+	{
+		std::string name{};
+		uint64_t featureMask = 0;
+
+		bool operator==(ProgramVariantKey const& other) const = default;
+	};
+
 	struct ProgramDescription
 	{
 		Program* program;
 		bool autoReload = false;
 		bool uiOpen = false;
+
+		// Set for programs compiled by a named ProgramVariants.
+		std::optional<ProgramVariantKey> variant{};
+
+		// Files the program is built from, watched by ProgramReloader when autoReload is set.
+		std::vector<std::filesystem::path> sourcePaths{};
 	};
 
 	struct ProgramRegistry
@@ -0,0 +1,121 @@
+#include "render/opengl/ProgramReloader.h"
+
+#include <algorithm>
+
+#include "render/opengl/OpenglContext.h"
+
+namespace render::opengl
+{
+	void ProgramReloader::watch(Program& program, std::vector<std::filesystem::path> paths) {
+		auto& description = this->openglContext.programRegistry.programs[program.ID.data];
+		description.program = &program;
+		description.autoReload = true;
+
+		for (auto& path : paths) {
+			if (std::ranges::find(description.sourcePaths, path) == description.sourcePaths.end()) {
+				description.sourcePaths.push_back(std::move(path));
+			}
+		}
+	}
+
+	void ProgramReloader::update() {
+		auto& programs = this->openglContext.programRegistry.programs;
+
+		for (auto const& [ID, description] : programs) {
+			if (description.autoReload) {
+				for (auto const& path : description.sourcePaths) {
+					this->fileWatcher.watch(path);
+				}
+			}
+		}
+
+		auto changed = this->fileWatcher.poll();
+
+		if (!changed.empty()) {
+			std::vector<Program*> changedPrograms{};
+
+			for (auto const& [ID, description] : programs) {
+				if (!description.autoReload || description.program == nullptr) {
+					continue;
+				}
+
+				auto affected = std::ranges::any_of(description.sourcePaths, [&](auto const& path) {
+					return std::ranges::any_of(changed, [&](auto const& changedPath) {
+						std::error_code error{};
+						return std::filesystem::equivalent(path, changedPath, error);
+					});
+				});
+
+				if (affected) {
+					changedPrograms.push_back(description.program);
+				}
+			}
+
+			for (auto program : changedPrograms) {
+				this->submit(*program);
+			}
+		}
+
+		this->batchLoader.update();
+
+		std::erase_if(this->pending, [&](PendingReload& reload) {
+			if (reload.program.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				return false;
+			}
+
+			auto newProgram = reload.program.get();
+			auto program = this->openglContext.programRegistry.lookup(reload.ID);
+
+			if (!newProgram.has_value() || !program.has_value()) {
+				return true;
+			}
+
+			auto& oldProgram = program.value();
+
+			newProgram->name = oldProgram.name;
+			newProgram->shaderSourceGenerators = std::move(oldProgram.shaderSourceGenerators);
+			newProgram->shaderSources = std::move(oldProgram.shaderSources);
+
+			oldProgram = std::move(newProgram.value());
+			oldProgram.refreshUniforms();
+
+			this->openglContext.logInfo("Reloaded program {}\n", oldProgram.ID.data);
+
+			return true;
+		});
+	}
+
+	ProgramReloader::ProgramReloader(OpenglContext& openglContext_)
+	    : openglContext(openglContext_),
+	      batchLoader(openglContext_) {
+	}
+
+	void ProgramReloader::submit(Program& program) {
+		auto ID = program.ID.data;
+
+		if (std::ranges::any_of(this->pending, [&](auto const& reload) { return reload.ID == ID; })) {
+			return;
+		}
+
+		std::optional<std::future<std::optional<Program>>> future{};
+
+		if (program.shaderSourceGenerators.has_value()) {
+			auto vertexSource = program.shaderSourceGenerators->vertexGenerator();
+			auto fragmentSource = program.shaderSourceGenerators->fragmentGenerator();
+
+			if (vertexSource.has_value() && fragmentSource.has_value()) {
+				future = this->batchLoader.load(vertexSource->get()->getSpan<char>(), fragmentSource->get()->getSpan<char>());
+			}
+		}
+		else if (program.shaderSources.has_value()) {
+			future = this->batchLoader.load(program.shaderSources->vertexSource->copy(), program.shaderSources->fragmentSource->copy());
+		}
+
+		if (!future.has_value()) {
+			this->openglContext.logWarning("Program {} changed on disk but has no sources to reload from.\n", ID);
+			return;
+		}
+
+		this->pending.push_back({ ID, std::move(future.value()) });
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <vector>
+
+#include <misc/Misc.h>
+
+#include "render/FileWatcher.h"
+#include "render/opengl/ProgramBatchLoader.h"
+
+namespace render::opengl
+{
+	// Drives ProgramDescription::autoReload: watches the source files of registered programs and relinks
+	// the programs whose sources changed through a ProgramBatchLoader. A program is only replaced once its
+	// new version linked successfully, its uniforms are refreshed after the swap.
+	struct ProgramReloader
+	{
+		OpenglContext& openglContext;
+
+		FileWatcher fileWatcher{};
+		ProgramBatchLoader batchLoader;
+
+		// For programs built from generators, whose files are not known to the registry.
+		void watch(Program& program, std::vector<std::filesystem::path> paths);
+
+		// Call once per frame on the thread owning the context.
+		void update();
+
+		ProgramReloader(OpenglContext& openglContext);
+		~ProgramReloader() = default;
+
+		NO_COPY_MOVE(ProgramReloader);
+
+	private:
+		struct PendingReload
+		{
+			GLuint ID{};
+			std::future<std::optional<Program>> program{};
+		};
+
+		std::vector<PendingReload> pending{};
+
+		void submit(Program& program);
+	};
+}
@@ -0,0 +1,213 @@
+#include "render/opengl/ProgramWarmup.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "render/Hash.h"
+#include "render/opengl/Program.h"
+#include "render/opengl/ShaderPreprocessor.h"
+
+namespace render::opengl
+{
+	namespace
+	{
+		template<class E>
+		std::optional<E> readEnum(std::istream& in) {
+			int32_t value = -1;
+			in >> value;
+
+			if (!in || value < 0 || value >= static_cast<int32_t>(E::MAX)) {
+				return std::nullopt;
+			}
+
+			return static_cast<E>(value);
+		}
+
+		std::optional<ProgramWarmupEntry> parseEntry(std::string const& line) {
+			std::istringstream in(line);
+
+			ProgramWarmupEntry result{};
+			in >> result.variant.featureMask;
+
+			auto blend = readEnum<Blend>(in);
+			auto blendFunc = readEnum<BlendFunc>(in);
+			auto blendEquation = readEnum<BlendEquation>(in);
+			auto depthTest = readEnum<DepthTest>(in);
+			auto depthFunc = readEnum<DepthFunc>(in);
+			auto depthMask = readEnum<DepthMask>(in);
+			auto srgbMode = readEnum<SRGBMode>(in);
+			in >> result.configuration.pointSize;
+
+			if (!in || !blend || !blendFunc || !blendEquation || !depthTest || !depthFunc || !depthMask || !srgbMode) {
+				return std::nullopt;
+			}
+
+			result.configuration.blend = blend.value();
+			result.configuration.blendFunc = blendFunc.value();
+			result.configuration.blendEquation = blendEquation.value();
+			result.configuration.depthTest = depthTest.value();
+			result.configuration.depthFunc = depthFunc.value();
+			result.configuration.depthMask = depthMask.value();
+			result.configuration.srgbMode = srgbMode.value();
+
+			in.get();
+			std::getline(in, result.variant.name);
+
+			if (result.variant.name.empty()) {
+				return std::nullopt;
+			}
+
+			return result;
+		}
+	}
+
+	std::size_t ProgramWarmupEntry::Hasher::operator()(ProgramWarmupEntry const& entry) const {
+		return static_cast<std::size_t>(hashBytes(entry.variant.name, entry.configuration.getHash() ^ entry.variant.featureMask));
+	}
+
+	void ProgramWarmup::add(ProgramVariants& variants) {
+		tassert(!variants.name.empty());
+		this->variantSets[variants.name] = &variants;
+	}
+
+	void ProgramWarmup::record() {
+		auto const& usedProgram = this->openglContext.usedProgram;
+		auto const& configuration = this->openglContext.configuration;
+
+		if (this->lastProgram == usedProgram && this->lastConfiguration == configuration) {
+			return;
+		}
+
+		this->lastProgram = usedProgram;
+		this->lastConfiguration = configuration;
+
+		auto it = this->openglContext.programRegistry.programs.find(usedProgram.data);
+
+		if (it == this->openglContext.programRegistry.programs.end() || !it->second.variant.has_value() || !configuration.isComplete()) {
+			return;
+		}
+
+		this->manifest.insert(ProgramWarmupEntry{
+		    .variant = it->second.variant.value(),
+		    .configuration = configuration,
+		});
+	}
+
+	bool ProgramWarmup::load(std::filesystem::path const& path) {
+		std::ifstream file(path);
+
+		if (!file.good()) {
+			return false;
+		}
+
+		std::string line{};
+		while (std::getline(file, line)) {
+			if (line.empty()) {
+				continue;
+			}
+
+			auto entry = parseEntry(line);
+
+			if (!entry.has_value()) {
+				this->openglContext.logWarning("Skipping malformed program warmup entry: {}\n", line);
+				continue;
+			}
+
+			if (this->manifest.insert(entry.value()).second) {
+				this->pending.push_back(std::move(entry.value()));
+			}
+		}
+
+		return true;
+	}
+
+	bool ProgramWarmup::save(std::filesystem::path const& path) const {
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+
+		if (!file.good()) {
+			return false;
+		}
+
+		for (auto const& entry : this->manifest) {
+			auto const& configuration = entry.configuration;
+
+			file << entry.variant.featureMask << ' '
+			     << static_cast<int32_t>(configuration.blend) << ' '
+			     << static_cast<int32_t>(configuration.blendFunc) << ' '
+			     << static_cast<int32_t>(configuration.blendEquation) << ' '
+			     << static_cast<int32_t>(configuration.depthTest) << ' '
+			     << static_cast<int32_t>(configuration.depthFunc) << ' '
+			     << static_cast<int32_t>(configuration.depthMask) << ' '
+			     << static_cast<int32_t>(configuration.srgbMode) << ' '
+			     << configuration.pointSize << ' '
+			     << entry.variant.name << '\n';
+		}
+
+		return file.good();
+	}
+
+	void ProgramWarmup::update() {
+		if (this->pending.empty()) {
+			return;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		auto previousConfiguration = this->openglContext.configuration;
+
+		std::size_t i = 0;
+		for (; i < this->pending.size(); i++) {
+			if (std::chrono::steady_clock::now() - start >= this->frameBudget) {
+				break;
+			}
+
+			this->warmup(this->pending[i]);
+		}
+
+		this->pending.erase(this->pending.begin(), this->pending.begin() + static_cast<std::ptrdiff_t>(i));
+
+		if (previousConfiguration.isComplete()) {
+			this->openglContext.setConfiguration(previousConfiguration);
+		}
+	}
+
+	bool ProgramWarmup::done() const {
+		return this->pending.empty();
+	}
+
+	ProgramWarmup::ProgramWarmup(OpenglContext& openglContext_)
+	    : openglContext(openglContext_) {
+		tassert(this->openglContext.programWarmup == nullptr);
+		this->openglContext.programWarmup = this;
+	}
+
+	ProgramWarmup::~ProgramWarmup() {
+		this->openglContext.programWarmup = nullptr;
+	}
+
+	void ProgramWarmup::warmup(ProgramWarmupEntry const& entry) {
+		auto it = this->variantSets.find(entry.variant.name);
+
+		if (it == this->variantSets.end()) {
+			this->openglContext.logWarning("No program variants named {} to warm up.\n", entry.variant.name);
+			return;
+		}
+
+		auto program = it->second->get(entry.variant.featureMask);
+
+		if (program == nullptr) {
+			return;
+		}
+
+		if (!this->emptyVAO.has_value()) {
+			this->emptyVAO.emplace(this->openglContext);
+		}
+
+		this->openglContext.setConfiguration(entry.configuration);
+		this->emptyVAO->bind();
+		program->use();
+
+		glEnable(GL_RASTERIZER_DISCARD);
+		glDrawArrays(GL_POINTS, 0, 1);
+		glDisable(GL_RASTERIZER_DISCARD);
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <misc/Misc.h>
+
+#include "render/opengl/OpenglContext.h"
+#include "render/opengl/OpenglVAO.h"
+
+namespace render::opengl
+{
+	struct ProgramVariants;
+
+	struct ProgramWarmupEntry
+	{
+		ProgramVariantKey variant{};
+		Configuration configuration{};
+
+		bool operator==(ProgramWarmupEntry const& other) const = default;
+
+		struct Hasher
+		{
+			std::size_t operator()(ProgramWarmupEntry const& entry) const;
+		};
+	};
+
+	// Records which program variants are drawn with which configurations and saves them to a manifest.
+	// After loading a manifest, update() compiles the recorded variants and issues a draw with rasterizer
+	// discard for every configuration, so drivers finish their state dependent recompiles ahead of the real draws.
+	struct ProgramWarmup
+	{
+		OpenglContext& openglContext;
+
+		std::chrono::microseconds frameBudget{ 2000 };
+
+		std::unordered_map<std::string, ProgramVariants*> variantSets{};
+
+		std::unordered_set<ProgramWarmupEntry, ProgramWarmupEntry::Hasher> manifest{};
+		std::vector<ProgramWarmupEntry> pending{};
+
+		// Variants are matched to manifest entries by their name.
+		void add(ProgramVariants& variants);
+
+		// Called from OpenglContext::tallyDrawCall.
+		void record();
+
+		// Loaded entries are queued for warm up and kept in the manifest.
+		bool load(std::filesystem::path const& path);
+		bool save(std::filesystem::path const& path) const;
+
+		// Call on idle frames, warms up pending entries until frameBudget is spent.
+		void update();
+		bool done() const;
+
+		ProgramWarmup(OpenglContext& openglContext);
+		~ProgramWarmup();
+
+		NO_COPY_MOVE(ProgramWarmup);
+
+	private:
+		Qualified<GLuint> lastProgram{};
+		Configuration lastConfiguration{};
+
+		std::optional<OpenglVAO> emptyVAO{};
+
+		void warmup(ProgramWarmupEntry const& entry);
+	};
+}
@@ -0,0 +1,203 @@
+#include "render/opengl/ShaderPreprocessor.h"
+
+#include "render/opengl/OpenglContext.h"
+
+#include <algorithm>
+#include <format>
+
+namespace render::opengl
+{
+	namespace
+	{
+		std::optional<std::string_view> getIncludeName(std::string_view line) {
+			auto begin = line.find_first_not_of(" \t");
+			if (begin == std::string_view::npos) {
+				return std::nullopt;
+			}
+
+			line = line.substr(begin);
+
+			constexpr std::string_view directive = "#include";
+			if (!line.starts_with(directive)) {
+				return std::nullopt;
+			}
+
+			line = line.substr(directive.size());
+
+			auto open = line.find_first_of("\"<");
+			if (open == std::string_view::npos) {
+				return std::nullopt;
+			}
+
+			auto close = line.find(line[open] == '"' ? '"' : '>', open + 1);
+			if (close == std::string_view::npos) {
+				return std::nullopt;
+			}
+
+			return line.substr(open + 1, close - open - 1);
+		}
+	}
+
+	std::optional<std::string> ShaderPreprocessor::process(OpenglContext& openglContext, std::string_view source, te::span<ShaderDefine const> defines) const {
+		auto body = openglContext.trimShaderPrefix(source);
+		auto header = source.substr(0, source.size() - body.size());
+
+		std::string result(header);
+		result += '\n';
+
+		for (auto const& define : defines) {
+			result += std::format("#define {} {}\n", define.name, define.value);
+		}
+
+		std::vector<std::string> included{};
+		auto firstLine = static_cast<integer_t>(std::ranges::count(header, '\n')) + 1;
+
+		if (!this->expand(openglContext, body, firstLine, 0, included, result)) {
+			return std::nullopt;
+		}
+
+		return result;
+	}
+
+	bool ShaderPreprocessor::expand(
+	    OpenglContext& openglContext,
+	    std::string_view source,
+	    integer_t firstLine,
+	    integer_t depth,
+	    std::vector<std::string>& included,
+	    std::string& out
+	) const {
+		if (depth > this->maxIncludeDepth) {
+			openglContext.logError("Shader includes nested deeper than {}.\n", this->maxIncludeDepth);
+			return false;
+		}
+
+		out += std::format("#line {}\n", firstLine);
+
+		auto lineNumber = firstLine;
+
+		while (!source.empty()) {
+			auto end = source.find('\n');
+			auto line = source.substr(0, end);
+			source = end == std::string_view::npos ? std::string_view() : source.substr(end + 1);
+
+			auto includeName = getIncludeName(line);
+
+			if (!includeName.has_value()) {
+				out += line;
+				out += '\n';
+			}
+			else if (std::ranges::find(included, includeName.value()) != included.end()) {
+				out += '\n';
+			}
+			else {
+				included.emplace_back(includeName.value());
+
+				auto includeSource = this->resolver ? this->resolver(includeName.value()) : nullptr;
+				auto includeData = includeSource != nullptr ? includeSource->data() : std::nullopt;
+
+				if (!includeData.has_value()) {
+					openglContext.logError("Failed to resolve shader include \"{}\".\n", includeName.value());
+					return false;
+				}
+
+				auto includeSpan = includeData.value()->get();
+
+				if (!this->expand(openglContext, std::string_view(includeSpan.data(), includeSpan.size()), 1, depth + 1, included, out)) {
+					return false;
+				}
+
+				out += std::format("#line {}\n", lineNumber + 1);
+			}
+
+			lineNumber++;
+		}
+
+		return true;
+	}
+
+	Program* ProgramVariants::get(uint64_t featureMask) {
+		if (auto it = this->variants.find(featureMask); it != this->variants.end()) {
+			return it->second.get();
+		}
+
+		auto& variant = this->variants[featureMask];
+
+		if (!this->readSources()) {
+			return nullptr;
+		}
+
+		auto variantDefines = this->getDefines(featureMask);
+
+		auto vertex = this->preprocessor.process(this->openglContext, this->vertexText.value(), variantDefines);
+		auto fragment = this->preprocessor.process(this->openglContext, this->fragmentText.value(), variantDefines);
+
+		if (!vertex.has_value() || !fragment.has_value()) {
+			return nullptr;
+		}
+
+		auto program = Program::load(
+		    this->openglContext,
+		    te::span<char const>(vertex->data(), vertex->size()),
+		    te::span<char const>(fragment->data(), fragment->size())
+		);
+
+		if (program.has_value()) {
+			variant = std::make_unique<Program>(std::move(program.value()));
+
+			if (!this->name.empty()) {
+				this->openglContext.registerProgram(*variant, ProgramDescription{ .program = variant.get(), .variant = ProgramVariantKey{ this->name, featureMask } });
+			}
+		}
+
+		return variant.get();
+	}
+
+	std::vector<ShaderDefine> ProgramVariants::getDefines(uint64_t featureMask) const {
+		tassert(this->features.size() >= 64 || (featureMask >> this->features.size()) == 0);
+
+		auto result = this->defines;
+
+		for (std::size_t i = 0; i < this->features.size() && i < 64; i++) {
+			if (featureMask & (uint64_t(1) << i)) {
+				result.push_back({ this->features[i], "1" });
+			}
+		}
+
+		return result;
+	}
+
+	void ProgramVariants::clear() {
+		this->variants.clear();
+		this->vertexText.reset();
+		this->fragmentText.reset();
+	}
+
+	ProgramVariants::ProgramVariants(OpenglContext& openglContext_, std::unique_ptr<DataSource> vertexSource_, std::unique_ptr<DataSource> fragmentSource_)
+	    : openglContext(openglContext_),
+	      vertexSource(std::move(vertexSource_)),
+	      fragmentSource(std::move(fragmentSource_)) {
+	}
+
+	bool ProgramVariants::readSources() {
+		if (this->vertexText.has_value() && this->fragmentText.has_value()) {
+			return true;
+		}
+
+		auto vertexData = this->vertexSource->data();
+		auto fragmentData = this->fragmentSource->data();
+
+		if (!vertexData.has_value() || !fragmentData.has_value()) {
+			this->openglContext.logError("Failed to read shader sources for program variants.\n");
+			return false;
+		}
+
+		auto vertexSpan = vertexData.value()->get();
+		auto fragmentSpan = fragmentData.value()->get();
+
+		this->vertexText = std::string(vertexSpan.data(), vertexSpan.size());
+		this->fragmentText = std::string(fragmentSpan.data(), fragmentSpan.size());
+
+		return true;
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <misc/Misc.h>
+
+#include <tepp/integers.h>
+#include <tepp/span.h>
+
+#include "render/opengl/Program.h"
+
+namespace render::opengl
+{
+	struct ShaderDefine
+	{
+		std::string name{};
+		std::string value{};
+	};
+
+	using IncludeResolver = std::function<std::unique_ptr<DataSource>(std::string_view name)>;
+
+	// Expands #include "name" lines through resolver and injects defines after the prefix
+	// that OpenglContext::trimShaderPrefix strips, so the result can be passed to Program::load as is.
+	// Every file is included at most once per shader.
+	struct ShaderPreprocessor
+	{
+		IncludeResolver resolver{};
+		integer_t maxIncludeDepth = 32;
+
+		std::optional<std::string> process(OpenglContext& openglContext, std::string_view source, te::span<ShaderDefine const> defines) const;
+
+	private:
+		bool expand(
+		    OpenglContext& openglContext,
+		    std::string_view source,
+		    integer_t firstLine,
+		    integer_t depth,
+		    std::vector<std::string>& included,
+		    std::string& out
+		) const;
+	};
+
+	// Permutations of one vertex and fragment shader pair, bit i of a feature mask defines features[i].
+	// Variants are compiled on first use and kept, failed compiles are remembered as nullptr.
+	struct ProgramVariants
+	{
+		OpenglContext& openglContext;
+		ShaderPreprocessor preprocessor{};
+
+		// Identifies the variants in the program registry and in ProgramWarmup manifests.
+		std::string name{};
+
+		std::unique_ptr<DataSource> vertexSource{};
+		std::unique_ptr<DataSource> fragmentSource{};
+
+		std::vector<std::string> features{};
+		std::vector<ShaderDefine> defines{};
+
+		std::unordered_map<uint64_t, std::unique_ptr<Program>> variants{};
+
+		Program* get(uint64_t featureMask);
+		std::vector<ShaderDefine> getDefines(uint64_t featureMask) const;
+
+		// Drops all compiled variants and cached sources, the next get() reads the sources again.
+		void clear();
+
+		ProgramVariants(OpenglContext& openglContext, std::unique_ptr<DataSource> vertexSource, std::unique_ptr<DataSource> fragmentSource);
+		~ProgramVariants() = default;
+
+		NO_COPY_MOVE(ProgramVariants);
+
+	private:
+		std::optional<std::string> vertexText{};
+		std::optional<std::string> fragmentText{};
+
+		bool readSources();
+	};
+}
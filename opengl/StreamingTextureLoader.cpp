@@ -0,0 +1,152 @@
+#include "render/opengl/StreamingTextureLoader.h"
+
+#include <wrangled_gl/wrangled_gl.h>
+
+#if defined(COMPILER_CLANGCL) || defined(COMPILER_CLANG)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-qualifiers"
+#pragma clang diagnostic ignored "-Wdeprecated-anon-enum-enum-conversion"
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wmissing-template-arg-list-after-template-kw"
+#elif defined(COMPILER_MSVC)
+#pragma warning(push, 0)
+#pragma warning(disable : 4201; disable : 4324; disable : 4310)
+#endif
+
+#include <gli/gli.hpp>
+
+#if defined(COMPILER_CLANGCL) || defined(COMPILER_CLANG)
+#pragma clang diagnostic pop
+#elif defined(COMPILER_MSVC)
+#pragma warning(pop)
+#endif
+
+#include "render/opengl/OpenglContext.h"
+
+#include <tepp/safety_cast.h>
+
+namespace render::opengl
+{
+	bool StreamingTexture::isResident() const {
+		return this->residentLevel == 0;
+	}
+
+	void StreamingTexture::bind() {
+		std::visit([](auto& t) { t.bind(); }, this->texture);
+	}
+
+	StreamingTexture::StreamingTexture(impl::LoadedTexture texture_)
+	    : texture(std::move(texture_)) {
+	}
+
+	StreamingTexture::~StreamingTexture() {
+	}
+
+	std::shared_ptr<StreamingTexture> TextureStreamer::load(te::span<char const> buffer, bool SRGB) {
+		gli::texture Texture = gli::load_dds(buffer.data(), buffer.size());
+
+		if (Texture.empty()) {
+			this->openglContext.logError("Failed to parse texture for streaming.\n");
+			return nullptr;
+		}
+
+		auto uploadFormat = impl::translateFormat(Texture, SRGB);
+
+		if (!uploadFormat.has_value()) {
+			this->openglContext.logError("Unsupported texture target for streaming.\n");
+			return nullptr;
+		}
+
+		auto texture = impl::allocateTexture(this->openglContext, Texture, uploadFormat.value());
+
+		if (!texture.has_value()) {
+			return nullptr;
+		}
+
+		auto result = std::make_shared<StreamingTexture>(std::move(texture.value()));
+		result->levels = te::safety_cast<int32_t>(Texture.levels());
+		result->residentLevel = result->levels;
+		result->uploadFormat = uploadFormat.value();
+		result->source = std::make_unique<gli::texture>(std::move(Texture));
+
+		integer_t uploaded = 0;
+		while (!result->isResident()) {
+			auto byteSize = impl::getLevelByteSize(*result->source, result->residentLevel - 1);
+
+			if (result->residentLevel != result->levels && uploaded + byteSize > this->initialByteBudget) {
+				break;
+			}
+
+			uploadNextLevel(*result);
+			uploaded += byteSize;
+		}
+
+		if (result->isResident()) {
+			result->source.reset();
+		}
+		else {
+			this->pending.push_back(result);
+		}
+
+		return result;
+	}
+
+	void TextureStreamer::update() {
+		std::erase_if(this->pending, [](auto const& streamingTexture) {
+			return streamingTexture.use_count() == 1;
+		});
+
+		auto budget = this->frameByteBudget;
+		bool uploaded = false;
+
+		for (bool progress = true; progress;) {
+			progress = false;
+
+			for (auto& streamingTexture : this->pending) {
+				if (streamingTexture->isResident()) {
+					continue;
+				}
+
+				auto byteSize = impl::getLevelByteSize(*streamingTexture->source, streamingTexture->residentLevel - 1);
+
+				if (uploaded && byteSize > budget) {
+					continue;
+				}
+
+				uploadNextLevel(*streamingTexture);
+				budget -= byteSize;
+				uploaded = true;
+				progress = true;
+			}
+		}
+
+		std::erase_if(this->pending, [](auto const& streamingTexture) {
+			if (streamingTexture->isResident()) {
+				streamingTexture->source.reset();
+				return true;
+			}
+			return false;
+		});
+	}
+
+	bool TextureStreamer::done() const {
+		return this->pending.empty();
+	}
+
+	TextureStreamer::TextureStreamer(OpenglContext& openglContext_)
+	    : openglContext(openglContext_) {
+	}
+
+	void TextureStreamer::uploadNextLevel(StreamingTexture& streamingTexture) {
+		tassert(!streamingTexture.isResident());
+
+		auto level = streamingTexture.residentLevel - 1;
+
+		streamingTexture.bind();
+		impl::uploadLevel(*streamingTexture.source, streamingTexture.uploadFormat, level);
+		glTexParameteri(streamingTexture.uploadFormat.target, GL_TEXTURE_BASE_LEVEL, level);
+
+		streamingTexture.residentLevel = level;
+	}
+}
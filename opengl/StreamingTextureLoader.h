@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include <tepp/integers.h>
+#include <tepp/span.h>
+
+#include "render/opengl/OpenglTexture.h"
+#include "render/opengl/TextureLoader.h"
+
+namespace render::opengl
+{
+	struct StreamingTexture
+	{
+		impl::LoadedTexture texture;
+
+		// Lowest level with data on the gpu, GL_TEXTURE_BASE_LEVEL is clamped to this.
+		int32_t residentLevel{};
+		int32_t levels{};
+
+		// Kept until every level is resident.
+		std::unique_ptr<gli::texture> source{};
+		impl::UploadFormat uploadFormat{};
+
+		bool isResident() const;
+
+		void bind();
+
+		StreamingTexture(impl::LoadedTexture texture);
+
+		NO_COPY_MOVE(StreamingTexture);
+
+		~StreamingTexture();
+	};
+
+	// Uploads the smallest levels of a texture on load and streams in the larger levels over later
+	// frames. Textures sharpen round robin, one level per texture at a time.
+	struct TextureStreamer
+	{
+		OpenglContext& openglContext;
+
+		// Levels are uploaded at load until the next one would exceed this.
+		integer_t initialByteBudget = 64 * 1024;
+		// Upload budget for a single update, at least one level is uploaded per update when anything is pending.
+		integer_t frameByteBudget = 4 * 1024 * 1024;
+
+		std::vector<std::shared_ptr<StreamingTexture>> pending{};
+
+		std::shared_ptr<StreamingTexture> load(te::span<char const> buffer, bool SRGB = true);
+
+		// Call once per frame on the thread owning the context.
+		void update();
+
+		bool done() const;
+
+		TextureStreamer(OpenglContext& openglContext);
+		~TextureStreamer() = default;
+
+		NO_COPY_MOVE(TextureStreamer);
+
+	private:
+		static void uploadNextLevel(StreamingTexture& streamingTexture);
+	};
+}
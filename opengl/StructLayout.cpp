@@ -0,0 +1,5 @@
+#include "render/opengl/StructLayout.h"
+
+namespace render::opengl
+{
+}
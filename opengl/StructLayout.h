@@ -0,0 +1,210 @@
+#pragma once
+
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <wglm/glm.hpp>
+#include <wglm/mat3x3.hpp>
+#include <wglm/mat3x4.hpp>
+#include <wglm/mat4x4.hpp>
+#include <wglm/vec2.hpp>
+#include <wglm/vec3.hpp>
+#include <wglm/vec4.hpp>
+
+#include <tepp/integers.h>
+
+#include <wrangled_gl/wrangled_gl.h>
+
+#include "render/Color.h"
+#include "render/DataType.h"
+#include "render/opengl/OpenglVAO.h"
+
+namespace render::opengl
+{
+	template<class T>
+	struct VertexDataType;
+
+	// Field type for DataTypes without a matching C++ type, Storage holds the raw bits the GL reads.
+	template<DataType dataType_, class Storage>
+	struct PackedAttribute
+	{
+		Storage data{};
+	};
+
+	using Half2 = PackedAttribute<DataType::f16vec2, glm::u16vec2>;
+	using Half4 = PackedAttribute<DataType::f16vec4, glm::u16vec4>;
+	using Snorm16x2 = PackedAttribute<DataType::snorm16vec2, glm::i16vec2>;
+	using Snorm16x4 = PackedAttribute<DataType::snorm16vec4, glm::i16vec4>;
+	using Unorm16x2 = PackedAttribute<DataType::unorm16vec2, glm::u16vec2>;
+	using Unorm16x4 = PackedAttribute<DataType::unorm16vec4, glm::u16vec4>;
+	using Snorm2_10_10_10 = PackedAttribute<DataType::snorm2_10_10_10, uint32_t>;
+
+	template<DataType dataType_, class Storage>
+	struct VertexDataType<PackedAttribute<dataType_, Storage>>
+	{
+		static constexpr DataType dataType = dataType_;
+		static_assert(sizeof(Storage) == dataTypeByteSize[dataType]);
+	};
+
+	// TYPE, DATA_TYPE
+#define VERTEX_DATA_TYPE_LIST(X) \
+	X(float, f32) \
+	X(glm::vec2, vec2) \
+	X(glm::vec3, vec3) \
+	X(glm::vec4, vec4) \
+	X(int32_t, i32) \
+	X(glm::ivec2, ivec2) \
+	X(glm::i16vec2, i16vec2) \
+	X(glm::ivec3, ivec3) \
+	X(glm::ivec4, ivec4) \
+	X(uint32_t, u32) \
+	X(glm::uvec2, uvec2) \
+	X(glm::uvec3, uvec3) \
+	X(glm::uvec4, uvec4) \
+	X(glm::mat2, mat2) \
+	X(glm::mat3, mat3) \
+	X(glm::mat4, mat4) \
+	X(glm::mat2x3, mat2x3) \
+	X(glm::mat3x2, mat3x2) \
+	X(glm::mat2x4, mat2x4) \
+	X(glm::mat4x2, mat4x2) \
+	X(glm::mat3x4, mat3x4) \
+	X(glm::mat4x3, mat4x3) \
+	X(Color, coloru32)
+
+#define DEFINE_VERTEX_DATA_TYPE(TYPE, DATA_TYPE) \
+	template<> \
+	struct VertexDataType<TYPE> \
+	{ \
+		static constexpr DataType dataType = DataType::DATA_TYPE; \
+		static_assert(sizeof(TYPE) == dataTypeByteSize[dataType]); \
+	};
+
+	VERTEX_DATA_TYPE_LIST(DEFINE_VERTEX_DATA_TYPE)
+
+#undef DEFINE_VERTEX_DATA_TYPE
+#undef VERTEX_DATA_TYPE_LIST
+
+	namespace impl
+	{
+		struct AnyField
+		{
+			template<class T>
+			constexpr operator T() const noexcept;
+		};
+
+		template<class T, class... Fields>
+		consteval integer_t countFields() {
+			if constexpr (requires { T{ Fields{}..., AnyField{} }; }) {
+				return countFields<T, Fields..., AnyField>();
+			}
+			else {
+				return sizeof...(Fields);
+			}
+		}
+
+		// Only used in unevaluated context, the structured binding names the declared type of every field.
+		template<class T>
+		auto getFieldTypes(T const& t) {
+			constexpr auto count = countFields<T>();
+			static_assert(count <= 12, "Vertex structs are limited to 12 fields.");
+
+			if constexpr (count == 1) {
+				auto const& [a] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>>>{};
+			}
+			else if constexpr (count == 2) {
+				auto const& [a, b] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>>>{};
+			}
+			else if constexpr (count == 3) {
+				auto const& [a, b, c] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>, std::remove_cvref_t<decltype(c)>>>{};
+			}
+			else if constexpr (count == 4) {
+				auto const& [a, b, c, d] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>, std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>>>{};
+			}
+			else if constexpr (count == 5) {
+				auto const& [a, b, c, d, e] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>, std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>, std::remove_cvref_t<decltype(e)>>>{};
+			}
+			else if constexpr (count == 6) {
+				auto const& [a, b, c, d, e, f] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>, std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>, std::remove_cvref_t<decltype(e)>, std::remove_cvref_t<decltype(f)>>>{};
+			}
+			else if constexpr (count == 7) {
+				auto const& [a, b, c, d, e, f, g] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>, std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>, std::remove_cvref_t<decltype(e)>, std::remove_cvref_t<decltype(f)>, std::remove_cvref_t<decltype(g)>>>{};
+			}
+			else if constexpr (count == 8) {
+				auto const& [a, b, c, d, e, f, g, h] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>, std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>, std::remove_cvref_t<decltype(e)>, std::remove_cvref_t<decltype(f)>, std::remove_cvref_t<decltype(g)>, std::remove_cvref_t<decltype(h)>>>{};
+			}
+			else if constexpr (count == 9) {
+				auto const& [a, b, c, d, e, f, g, h, i] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>, std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>, std::remove_cvref_t<decltype(e)>, std::remove_cvref_t<decltype(f)>, std::remove_cvref_t<decltype(g)>, std::remove_cvref_t<decltype(h)>, std::remove_cvref_t<decltype(i)>>>{};
+			}
+			else if constexpr (count == 10) {
+				auto const& [a, b, c, d, e, f, g, h, i, j] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>, std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>, std::remove_cvref_t<decltype(e)>, std::remove_cvref_t<decltype(f)>, std::remove_cvref_t<decltype(g)>, std::remove_cvref_t<decltype(h)>, std::remove_cvref_t<decltype(i)>, std::remove_cvref_t<decltype(j)>>>{};
+			}
+			else if constexpr (count == 11) {
+				auto const& [a, b, c, d, e, f, g, h, i, j, k] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>, std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>, std::remove_cvref_t<decltype(e)>, std::remove_cvref_t<decltype(f)>, std::remove_cvref_t<decltype(g)>, std::remove_cvref_t<decltype(h)>, std::remove_cvref_t<decltype(i)>, std::remove_cvref_t<decltype(j)>, std::remove_cvref_t<decltype(k)>>>{};
+			}
+			else {
+				auto const& [a, b, c, d, e, f, g, h, i, j, k, l] = t;
+				return std::type_identity<std::tuple<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>, std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>, std::remove_cvref_t<decltype(e)>, std::remove_cvref_t<decltype(f)>, std::remove_cvref_t<decltype(g)>, std::remove_cvref_t<decltype(h)>, std::remove_cvref_t<decltype(i)>, std::remove_cvref_t<decltype(j)>, std::remove_cvref_t<decltype(k)>, std::remove_cvref_t<decltype(l)>>>{};
+			}
+		}
+
+		template<class T>
+		using FieldTypes = typename decltype(getFieldTypes(std::declval<T const&>()))::type;
+
+		template<class Fields, GLuint divisor, std::size_t... I>
+		consteval auto makeAttributes(std::index_sequence<I...>) {
+			std::array<DataType, sizeof...(I)> dataTypes{ VertexDataType<std::tuple_element_t<I, Fields>>::dataType... };
+			std::array<VertexAttribute, sizeof...(I)> attributes{};
+
+			integer_t offset = 0;
+			for (std::size_t i = 0; i < sizeof...(I); i++) {
+				attributes[i] = VertexAttribute{
+					.dataType = dataTypes[i],
+					.offset = offset,
+					.divisor = divisor,
+				};
+				offset += dataTypeByteSize[dataTypes[i]];
+			}
+
+			return attributes;
+		}
+	}
+
+	// Vertex attributes of the aggregate T, one per field in declaration order. Fields are packed the
+	// same way Descriptor::add packs them, a struct with padding or with a field type that has no
+	// VertexDataType does not compile. Normalization follows from the DataType, as in getAttributeFormat.
+	template<class T, GLuint divisor = 0>
+	struct StructLayout
+	{
+		static_assert(std::is_aggregate_v<T>);
+		static_assert(std::is_standard_layout_v<T>);
+		static_assert(std::is_trivially_copyable_v<T>);
+
+		using Fields = impl::FieldTypes<T>;
+
+		static constexpr std::array<VertexAttribute, std::tuple_size_v<Fields>> attributes = impl::makeAttributes<Fields, divisor>(std::make_index_sequence<std::tuple_size_v<Fields>>());
+
+		static constexpr GLsizei stride = [] {
+			integer_t result = 0;
+			for (auto const& attribute : attributes) {
+				result += dataTypeByteSize[attribute.dataType];
+			}
+			return static_cast<GLsizei>(result);
+		}();
+
+		static_assert(sizeof(T) == stride, "Vertex struct has padding between or after its fields.");
+	};
+}
@@ -0,0 +1,280 @@
+#include "render/opengl/TextureArchive.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <tuple>
+
+#include "render/Hash.h"
+
+namespace render::opengl
+{
+	namespace
+	{
+		uint64_t getBucket(uint64_t hash, uint32_t bucketBits) {
+			if (bucketBits == 0) {
+				return 0;
+			}
+
+			return hash >> (64 - bucketBits);
+		}
+
+		uint64_t alignUp(uint64_t value, uint64_t alignment) {
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		template<class T>
+		std::optional<te::span<T const>> getTable(te::span<char const> file, uint64_t offset, uint64_t count) {
+			if (offset > file.size() || count > (file.size() - offset) / sizeof(T)) {
+				return std::nullopt;
+			}
+
+			auto ptr = file.data() + offset;
+
+			if (reinterpret_cast<std::uintptr_t>(ptr) % alignof(T) != 0) {
+				return std::nullopt;
+			}
+
+			return te::span<T const>(reinterpret_cast<T const*>(ptr), static_cast<std::size_t>(count));
+		}
+	}
+
+	std::optional<te::span<char const>> TextureArchive::find(std::string_view name) const {
+		auto hash = hashBytes(name);
+		auto bucket = getBucket(hash, this->header.bucketBits);
+
+		for (auto i = this->buckets[bucket]; i < this->buckets[bucket + 1]; i++) {
+			auto const& entry = this->entries[i];
+
+			if (entry.hash == hash && std::string_view(this->names.data() + entry.nameOffset, entry.nameSize) == name) {
+				return this->data->get().subspan(entry.offset, entry.size);
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	std::shared_ptr<TextureArchive> TextureArchive::open(std::unique_ptr<Data> data) {
+		if (data == nullptr) {
+			return nullptr;
+		}
+
+		auto file = data->get();
+
+		if (file.size() < sizeof(TextureArchiveHeader)) {
+			return nullptr;
+		}
+
+		auto result = std::make_shared<TextureArchive>();
+		std::memcpy(&result->header, file.data(), sizeof(TextureArchiveHeader));
+
+		auto const& header = result->header;
+
+		if (header.magic != TextureArchiveHeader::MAGIC || header.version != TextureArchiveHeader::VERSION || header.bucketBits > 32) {
+			return nullptr;
+		}
+
+		auto entries = getTable<TextureArchiveEntry>(file, header.entriesOffset, header.entryCount);
+		auto buckets = getTable<uint32_t>(file, header.bucketsOffset, (uint64_t(1) << header.bucketBits) + 1);
+
+		if (!entries.has_value() || !buckets.has_value() || header.namesOffset > file.size()) {
+			return nullptr;
+		}
+
+		result->entries = entries.value();
+		result->buckets = buckets.value();
+		result->names = file.subspan(header.namesOffset);
+
+		if (result->buckets.back() != header.entryCount) {
+			return nullptr;
+		}
+
+		for (std::size_t bucket = 0; bucket + 1 < result->buckets.size(); bucket++) {
+			if (result->buckets[bucket] > result->buckets[bucket + 1]) {
+				return nullptr;
+			}
+		}
+
+		for (auto const& entry : result->entries) {
+			if (entry.offset > file.size() || entry.size > file.size() - entry.offset) {
+				return nullptr;
+			}
+
+			if (entry.nameOffset > result->names.size() || entry.nameSize > result->names.size() - entry.nameOffset) {
+				return nullptr;
+			}
+		}
+
+		result->data = std::move(data);
+
+		return result;
+	}
+
+	std::shared_ptr<TextureArchive> TextureArchive::open(std::filesystem::path const& path) {
+		return open(MappedData::map(path));
+	}
+
+	void TextureArchiveWriter::add(std::string name, std::unique_ptr<DataSource> source) {
+		this->items.push_back({ std::move(name), std::move(source) });
+	}
+
+	bool TextureArchiveWriter::write(std::filesystem::path const& path) const {
+		if (this->alignment == 0 || !std::has_single_bit(this->alignment)) {
+			return false;
+		}
+
+		std::vector<DataSourceType> payloads{};
+		payloads.reserve(this->items.size());
+
+		for (auto const& item : this->items) {
+			auto payload = item.source->data();
+
+			if (!payload.has_value()) {
+				return false;
+			}
+
+			payloads.push_back(std::move(payload.value()));
+		}
+
+		std::vector<std::size_t> order(this->items.size());
+		std::vector<uint64_t> hashes(this->items.size());
+
+		for (std::size_t i = 0; i < this->items.size(); i++) {
+			order[i] = i;
+			hashes[i] = hashBytes(this->items[i].name);
+		}
+
+		std::ranges::sort(order, [&](auto a, auto b) {
+			return std::tie(hashes[a], this->items[a].name) < std::tie(hashes[b], this->items[b].name);
+		});
+
+		for (std::size_t i = 1; i < order.size(); i++) {
+			if (this->items[order[i - 1]].name == this->items[order[i]].name) {
+				return false;
+			}
+		}
+
+		TextureArchiveHeader header{};
+		header.entryCount = static_cast<uint32_t>(this->items.size());
+		header.bucketBits = static_cast<uint32_t>(std::bit_width(std::bit_ceil(std::max<std::size_t>(1, this->items.size())) - 1));
+		header.alignment = this->alignment;
+
+		auto bucketCount = uint64_t(1) << header.bucketBits;
+
+		header.entriesOffset = sizeof(TextureArchiveHeader);
+		header.bucketsOffset = header.entriesOffset + header.entryCount * sizeof(TextureArchiveEntry);
+		header.namesOffset = header.bucketsOffset + (bucketCount + 1) * sizeof(uint32_t);
+
+		std::vector<TextureArchiveEntry> entries(this->items.size());
+		std::vector<uint32_t> buckets(bucketCount + 1, 0);
+		std::string names{};
+
+		for (std::size_t i = 0; i < order.size(); i++) {
+			auto const& item = this->items[order[i]];
+
+			entries[i].hash = hashes[order[i]];
+			entries[i].nameOffset = static_cast<uint32_t>(names.size());
+			entries[i].nameSize = static_cast<uint32_t>(item.name.size());
+			names += item.name;
+
+			buckets[getBucket(entries[i].hash, header.bucketBits) + 1]++;
+		}
+
+		for (std::size_t bucket = 1; bucket < buckets.size(); bucket++) {
+			buckets[bucket] += buckets[bucket - 1];
+		}
+
+		auto offset = alignUp(header.namesOffset + names.size(), this->alignment);
+
+		for (std::size_t i = 0; i < order.size(); i++) {
+			entries[i].offset = offset;
+			entries[i].size = payloads[order[i]]->get().size();
+
+			offset = alignUp(offset + entries[i].size, this->alignment);
+		}
+
+		std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+		if (!file.good()) {
+			return false;
+		}
+
+		auto pad = [&file](uint64_t to) {
+			static constexpr char zeros[256]{};
+			for (auto position = static_cast<uint64_t>(file.tellp()); position < to;) {
+				auto count = std::min<uint64_t>(sizeof(zeros), to - position);
+				file.write(zeros, static_cast<std::streamsize>(count));
+				position += count;
+			}
+		};
+
+		file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		file.write(reinterpret_cast<char const*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(TextureArchiveEntry)));
+		file.write(reinterpret_cast<char const*>(buckets.data()), static_cast<std::streamsize>(buckets.size() * sizeof(uint32_t)));
+		file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+		for (std::size_t i = 0; i < order.size(); i++) {
+			auto payload = payloads[order[i]]->get();
+
+			pad(entries[i].offset);
+			file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+		}
+
+		return file.good();
+	}
+
+	bool packTextureArchive(std::filesystem::path const& root, std::filesystem::path const& output) {
+		std::error_code error{};
+		auto writer = TextureArchiveWriter();
+
+		for (auto const& entry : std::filesystem::recursive_directory_iterator(root, error)) {
+			if (!entry.is_regular_file()) {
+				continue;
+			}
+
+			writer.add(entry.path().lexically_relative(root).generic_string(), MappedFileSource::make(entry.path()));
+		}
+
+		if (error) {
+			return false;
+		}
+
+		return writer.write(output);
+	}
+
+	te::span<char const> ArchiveData::get() const {
+		return this->data;
+	}
+
+	ArchiveSource::ArchiveSource(std::shared_ptr<TextureArchive const> archive_, std::string name_)
+	    : archive(std::move(archive_)),
+	      name(std::move(name_)) {
+	}
+
+	std::optional<DataSourceType> ArchiveSource::data() const {
+		if (this->archive == nullptr) {
+			return std::nullopt;
+		}
+
+		auto span = this->archive->find(this->name);
+
+		if (!span.has_value()) {
+			return std::nullopt;
+		}
+
+		auto archiveData = std::make_unique<ArchiveData>();
+		archiveData->archive = this->archive;
+		archiveData->data = span.value();
+
+		return archiveData;
+	}
+
+	std::unique_ptr<DataSource> ArchiveSource::copy() const {
+		return std::make_unique<ArchiveSource>(this->archive, this->name);
+	}
+
+	std::unique_ptr<DataSource> ArchiveSource::make(std::shared_ptr<TextureArchive const> archive, std::string name) {
+		return std::make_unique<ArchiveSource>(std::move(archive), std::move(name));
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <tepp/span.h>
+
+#include "render/opengl/Program.h"
+
+namespace render::opengl
+{
+	// Layout of an archive file, all offsets are from the start of the file:
+	// header, entries sorted by name hash, bucket table of bucketCount + 1 entry indices,
+	// name strings, then the payloads each starting at a multiple of alignment.
+	// An entry lives in bucket (hash >> (64 - bucketBits)), so a bucket is a contiguous run of entries.
+	struct TextureArchiveHeader
+	{
+		static constexpr uint32_t MAGIC = 0x52415452; // "RTAR"
+		static constexpr uint32_t VERSION = 1;
+
+		uint32_t magic = MAGIC;
+		uint32_t version = VERSION;
+		uint32_t entryCount{};
+		uint32_t bucketBits{};
+		uint64_t alignment{};
+		uint64_t entriesOffset{};
+		uint64_t bucketsOffset{};
+		uint64_t namesOffset{};
+	};
+
+	struct TextureArchiveEntry
+	{
+		uint64_t hash{};
+		uint64_t offset{};
+		uint64_t size{};
+		uint32_t nameOffset{};
+		uint32_t nameSize{};
+	};
+
+	static_assert(sizeof(TextureArchiveHeader) == 48);
+	static_assert(sizeof(TextureArchiveEntry) == 32);
+
+	struct TextureArchive
+	{
+		std::unique_ptr<Data> data{};
+
+		TextureArchiveHeader header{};
+		te::span<TextureArchiveEntry const> entries{};
+		te::span<uint32_t const> buckets{};
+		te::span<char const> names{};
+
+		std::optional<te::span<char const>> find(std::string_view name) const;
+
+		// Validates the header and tables, the payloads are not touched.
+		static std::shared_ptr<TextureArchive> open(std::unique_ptr<Data> data);
+		static std::shared_ptr<TextureArchive> open(std::filesystem::path const& path);
+	};
+
+	struct TextureArchiveWriter
+	{
+		uint64_t alignment = 64;
+
+		struct Item
+		{
+			std::string name{};
+			std::unique_ptr<DataSource> source{};
+		};
+
+		std::vector<Item> items{};
+
+		void add(std::string name, std::unique_ptr<DataSource> source);
+
+		bool write(std::filesystem::path const& path) const;
+	};
+
+	// Packs every regular file below root, entries are named by their path relative to root with '/' separators.
+	bool packTextureArchive(std::filesystem::path const& root, std::filesystem::path const& output);
+
+	// Keeps the archive alive for as long as the span is in use.
+	struct ArchiveData : Data
+	{
+		std::shared_ptr<TextureArchive const> archive{};
+		te::span<char const> data{};
+
+		virtual te::span<char const> get() const override;
+	};
+
+	struct ArchiveSource : DataSource
+	{
+		std::shared_ptr<TextureArchive const> archive{};
+		std::string name{};
+
+		ArchiveSource() = default;
+		ArchiveSource(std::shared_ptr<TextureArchive const> archive, std::string name);
+
+		std::optional<DataSourceType> data() const override;
+		std::unique_ptr<DataSource> copy() const override;
+		static std::unique_ptr<DataSource> make(std::shared_ptr<TextureArchive const> archive, std::string name);
+	};
+}
@@ -23,7 +23,9 @@
 #endif
 
 #include <ranges>
+#include <utility>
 
+#include "render/opengl/DDSHeader.h"
 #include "render/opengl/OpenglContext.h"
 #include "render/opengl/OpenglTexture.h"
 
@@ -59,10 +61,72 @@ namespace render::opengl
 		return Opengl2DArrayTexture(openglContext);
 	}
 
-	impl::LoadTextureResult impl::loadTexture(
-	    OpenglContext& openglContext,
-	    gli::texture const& Texture, bool SRGB
-	) {
+	OpenglCubeTexture loadCubeTexture(OpenglContext& openglContext, te::span<char const> buffer, bool SRGB) {
+		gli::texture Texture = gli::load_dds(buffer.data(), buffer.size());
+
+		if (Texture.target() == gli::texture::target_type::TARGET_CUBE) {
+			if (auto result = impl::loadTexture(openglContext, Texture, SRGB)) {
+				if (auto t = std::get_if<OpenglCubeTexture>(&result.value())) {
+					return std::move(*t);
+				}
+			}
+		}
+
+		return OpenglCubeTexture(openglContext);
+	}
+
+	Opengl3DTexture load3DTexture(OpenglContext& openglContext, te::span<char const> buffer, bool SRGB) {
+		gli::texture Texture = gli::load_dds(buffer.data(), buffer.size());
+
+		if (Texture.target() == gli::texture::target_type::TARGET_3D) {
+			if (auto result = impl::loadTexture(openglContext, Texture, SRGB)) {
+				if (auto t = std::get_if<Opengl3DTexture>(&result.value())) {
+					return std::move(*t);
+				}
+			}
+		}
+
+		return Opengl3DTexture(openglContext);
+	}
+
+	std::optional<Opengl2DTexture> load2DTextureDirect(OpenglContext& openglContext, te::span<char const> buffer, bool SRGB) {
+		auto image = parseDDS(buffer);
+
+		if (!image.has_value()) {
+			openglContext.logError("Failed to parse DDS header or unsupported DDS format.\n");
+			return std::nullopt;
+		}
+
+		auto textureFormat = image->textureFormat;
+
+		if (image->cubemap || textureFormat.layers != 1) {
+			openglContext.logError("Expected a single 2D texture, DDS has {} layers.\n", textureFormat.layers);
+			return std::nullopt;
+		}
+
+		if (SRGB) {
+			switch (textureFormat.pixelFormat) {
+				case TextureFormat::PixelFormat::BC1:
+					textureFormat.pixelFormat = TextureFormat::PixelFormat::BC1_SRGB;
+					break;
+				case TextureFormat::PixelFormat::BC3:
+					textureFormat.pixelFormat = TextureFormat::PixelFormat::BC3_SRGB;
+					break;
+				case TextureFormat::PixelFormat::BC7:
+					textureFormat.pixelFormat = TextureFormat::PixelFormat::BC7_SRGB;
+					break;
+				default:
+					break;
+			}
+		}
+
+		textureFormat.filtering.LINEAR();
+		textureFormat.mipmapFiltering.LINEAR();
+
+		return Opengl2DTexture::make(openglContext, textureFormat, image->data);
+	}
+
+	std::optional<impl::UploadFormat> impl::translateFormat(gli::texture const& Texture, bool SRGB) {
 		gli::gl GL(gli::gl::PROFILE_GL33);
 		gli::gl::format const Format = GL.translate(Texture.format(), Texture.swizzles());
 
@@ -93,7 +157,32 @@ namespace render::opengl
 			}
 		}();
 
-		GLenum Target = GL.translate(Texture.target());
+		auto target = static_cast<GLenum>(GL.translate(Texture.target()));
+
+		if (target != GL_TEXTURE_2D && target != GL_TEXTURE_2D_ARRAY && target != GL_TEXTURE_CUBE_MAP && target != GL_TEXTURE_3D) {
+			return std::nullopt;
+		}
+
+		return UploadFormat{
+			.target = target,
+			.internalFormat = internalFormat,
+			.externalFormat = externalFormat,
+			.type = static_cast<GLenum>(Format.Type),
+			.swizzles = {
+			    static_cast<GLint>(Format.Swizzles[0]),
+			    static_cast<GLint>(Format.Swizzles[1]),
+			    static_cast<GLint>(Format.Swizzles[2]),
+			    static_cast<GLint>(Format.Swizzles[3]),
+			},
+		};
+	}
+
+	impl::LoadTextureResult impl::allocateTexture(
+	    OpenglContext& openglContext,
+	    gli::texture const& Texture,
+	    UploadFormat const& uploadFormat
+	) {
+		auto Target = uploadFormat.target;
 
 		glm::tvec3<GLsizei> const Extent1(Texture.extent());
 		GLsizei const FaceTotal = te::safety_cast<GLsizei>(Texture.layers() * Texture.faces());
@@ -101,9 +190,9 @@ namespace render::opengl
 		glm::ivec2 size{};
 
 		size.x = Extent1.x;
-		size.y = Texture.target() == gli::TARGET_2D || Texture.target() == gli::TARGET_2D_ARRAY ? Extent1.y : FaceTotal;
+		size.y = Texture.target() == gli::TARGET_1D_ARRAY ? FaceTotal : Extent1.y;
 
-		auto result = [&]() -> std::optional<std::variant<Opengl2DTexture, Opengl2DArrayTexture>> {
+		auto result = [&]() -> LoadTextureResult {
 			if (Target == GL_TEXTURE_2D) {
 				auto result = Opengl2DTexture(openglContext);
 				result.textureFormat.size = size;
@@ -119,6 +208,23 @@ namespace render::opengl
 				result.bind();
 				return result;
 			}
+			else if (Target == GL_TEXTURE_CUBE_MAP) {
+				auto result = OpenglCubeTexture(openglContext);
+				result.textureFormat.size = size;
+				result.textureFormat.mipmapLevels = te::safety_cast<int32_t>(Texture.levels());
+				glGenTextures(1, &result.ID.data);
+				result.bind();
+				return result;
+			}
+			else if (Target == GL_TEXTURE_3D) {
+				auto result = Opengl3DTexture(openglContext);
+				result.textureFormat.size = size;
+				result.textureFormat.layers = Extent1.z;
+				result.textureFormat.mipmapLevels = te::safety_cast<int32_t>(Texture.levels());
+				glGenTextures(1, &result.ID.data);
+				result.bind();
+				return result;
+			}
 			else {
 				return std::nullopt;
 			}
@@ -130,109 +236,175 @@ namespace render::opengl
 
 		glTexParameteri(Target, GL_TEXTURE_BASE_LEVEL, 0);
 		glTexParameteri(Target, GL_TEXTURE_MAX_LEVEL, te::safety_cast<GLint>(Texture.levels() - 1));
-		glTexParameteri(Target, GL_TEXTURE_SWIZZLE_R, Format.Swizzles[0]);
-		glTexParameteri(Target, GL_TEXTURE_SWIZZLE_G, Format.Swizzles[1]);
-		glTexParameteri(Target, GL_TEXTURE_SWIZZLE_B, Format.Swizzles[2]);
-		glTexParameteri(Target, GL_TEXTURE_SWIZZLE_A, Format.Swizzles[3]);
+		glTexParameteri(Target, GL_TEXTURE_SWIZZLE_R, uploadFormat.swizzles[0]);
+		glTexParameteri(Target, GL_TEXTURE_SWIZZLE_G, uploadFormat.swizzles[1]);
+		glTexParameteri(Target, GL_TEXTURE_SWIZZLE_B, uploadFormat.swizzles[2]);
+		glTexParameteri(Target, GL_TEXTURE_SWIZZLE_A, uploadFormat.swizzles[3]);
 		glTexParameteri(Target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(Target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(Target, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(Target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+		if (Target == GL_TEXTURE_CUBE_MAP || Target == GL_TEXTURE_3D) {
+			glTexParameteri(Target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(Target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexParameteri(Target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		}
+		else {
+			glTexParameteri(Target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTexParameteri(Target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		}
 
 		switch (Texture.target()) {
-			case gli::TARGET_1D_ARRAY:
 			case gli::TARGET_2D:
 			case gli::TARGET_CUBE:
 				glTexStorage2D(
-				    Target, te::safety_cast<GLint>(Texture.levels()), internalFormat,
-				    Extent1.x, Texture.target() == gli::TARGET_2D ? Extent1.y : FaceTotal
+				    Target, te::safety_cast<GLint>(Texture.levels()), uploadFormat.internalFormat,
+				    Extent1.x, Extent1.y
 				);
 				break;
 			case gli::TARGET_2D_ARRAY:
 				glTexStorage3D(
-				    Target, te::safety_cast<GLint>(Texture.levels()), internalFormat,
+				    Target, te::safety_cast<GLint>(Texture.levels()), uploadFormat.internalFormat,
 				    Extent1.x, Extent1.y, te::safety_cast<GLsizei>(Texture.layers())
 				);
 				break;
-			case gli::TARGET_1D:
 			case gli::TARGET_3D:
-			case gli::TARGET_CUBE_ARRAY:
+				glTexStorage3D(
+				    Target, te::safety_cast<GLint>(Texture.levels()), uploadFormat.internalFormat,
+				    Extent1.x, Extent1.y, Extent1.z
+				);
+				break;
 			default:
 				tassert(0);
 				break;
 		}
 
-		auto layers = Texture.layers();
-		auto faces = Texture.faces();
-		auto levels = Texture.levels();
-
-		for (std::size_t Layer = 0; Layer < layers; ++Layer) {
-			for (std::size_t Face = 0; Face < faces; ++Face) {
-				for (std::size_t Level = 0; Level < levels; ++Level) {
-					GLsizei const LayerGL = te::safety_cast<GLsizei>(Layer);
-					glm::tvec3<GLsizei> Extent(Texture.extent(Level));
-					Target = gli::is_target_cube(Texture.target())
-					             ? static_cast<GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + Face)
-					             : Target;
-
-					switch (Texture.target()) {
-						case gli::TARGET_1D_ARRAY:
-						case gli::TARGET_2D:
-						case gli::TARGET_CUBE:
-						{
-							if (gli::is_compressed(Texture.format())) {
-								glCompressedTexSubImage2D(
-								    Target, te::safety_cast<GLint>(Level),
-								    0, 0,
-								    Extent.x, Extent.y,
-								    internalFormat,
-								    te::safety_cast<GLsizei>(Texture.size(Level)),
-								    Texture.data(Layer, Face, Level)
-								);
-							}
-							else {
-								glTexSubImage2D(
-								    Target, te::safety_cast<GLint>(Level),
-								    0, 0,
-								    Extent.x,
-								    Texture.target() == gli::TARGET_1D_ARRAY ? LayerGL : Extent.y,
-								    externalFormat, Format.Type,
-								    Texture.data(Layer, Face, Level)
-								);
-							}
-						} break;
-						case gli::TARGET_2D_ARRAY:
-						{
-							if (gli::is_compressed(Texture.format())) {
-								glCompressedTexSubImage3D(
-								    Target, te::safety_cast<GLint>(Level),
-								    0, 0, te::safety_cast<GLint>(Layer),
-								    Extent.x, Extent.y, 1,
-								    internalFormat,
-								    te::safety_cast<GLsizei>(Texture.size(Level)),
-								    Texture.data(Layer, Face, Level)
-								);
-							}
-							else {
-								glTexSubImage3D(
-								    Target, te::safety_cast<GLint>(Level),
-								    0, 0, te::safety_cast<GLint>(Layer),
-								    Extent.x, Texture.target() == gli::TARGET_1D_ARRAY ? LayerGL : Extent.y, 1,
-								    externalFormat, Format.Type,
-								    Texture.data(Layer, Face, Level)
-								);
-							}
-						} break;
-						case gli::TARGET_1D:
-						case gli::TARGET_3D:
-						case gli::TARGET_CUBE_ARRAY:
-						default:
-							tassert(0);
-							break;
-					}
+		return result;
+	}
+
+	integer_t impl::getLevelByteSize(gli::texture const& Texture, integer_t level) {
+		return te::safety_cast<integer_t>(Texture.size(te::safety_cast<std::size_t>(level)) * Texture.layers() * Texture.faces());
+	}
+
+	void impl::uploadLevel(
+	    gli::texture const& Texture,
+	    UploadFormat const& uploadFormat,
+	    integer_t level,
+	    bool fromUnpackBuffer
+	) {
+		auto Level = te::safety_cast<std::size_t>(level);
+		auto LevelGL = te::safety_cast<GLint>(level);
+		glm::tvec3<GLsizei> Extent(Texture.extent(Level));
+		auto compressed = gli::is_compressed(Texture.format());
+
+		for (std::size_t Layer = 0; Layer < Texture.layers(); ++Layer) {
+			for (std::size_t Face = 0; Face < Texture.faces(); ++Face) {
+				void const* data = Texture.data(Layer, Face, Level);
+
+				if (fromUnpackBuffer) {
+					auto offset = static_cast<std::byte const*>(data) - static_cast<std::byte const*>(Texture.data());
+					data = reinterpret_cast<void const*>(offset);
+				}
+
+				switch (Texture.target()) {
+					case gli::TARGET_2D:
+					case gli::TARGET_CUBE:
+					{
+						auto Target = Texture.target() == gli::TARGET_CUBE
+						                  ? static_cast<GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + Face)
+						                  : uploadFormat.target;
+
+						if (compressed) {
+							glCompressedTexSubImage2D(
+							    Target, LevelGL,
+							    0, 0,
+							    Extent.x, Extent.y,
+							    uploadFormat.internalFormat,
+							    te::safety_cast<GLsizei>(Texture.size(Level)),
+							    data
+							);
+						}
+						else {
+							glTexSubImage2D(
+							    Target, LevelGL,
+							    0, 0,
+							    Extent.x, Extent.y,
+							    uploadFormat.externalFormat, uploadFormat.type,
+							    data
+							);
+						}
+					} break;
+					case gli::TARGET_2D_ARRAY:
+					{
+						if (compressed) {
+							glCompressedTexSubImage3D(
+							    uploadFormat.target, LevelGL,
+							    0, 0, te::safety_cast<GLint>(Layer),
+							    Extent.x, Extent.y, 1,
+							    uploadFormat.internalFormat,
+							    te::safety_cast<GLsizei>(Texture.size(Level)),
+							    data
+							);
+						}
+						else {
+							glTexSubImage3D(
+							    uploadFormat.target, LevelGL,
+							    0, 0, te::safety_cast<GLint>(Layer),
+							    Extent.x, Extent.y, 1,
+							    uploadFormat.externalFormat, uploadFormat.type,
+							    data
+							);
+						}
+					} break;
+					case gli::TARGET_3D:
+					{
+						if (compressed) {
+							glCompressedTexSubImage3D(
+							    uploadFormat.target, LevelGL,
+							    0, 0, 0,
+							    Extent.x, Extent.y, Extent.z,
+							    uploadFormat.internalFormat,
+							    te::safety_cast<GLsizei>(Texture.size(Level)),
+							    data
+							);
+						}
+						else {
+							glTexSubImage3D(
+							    uploadFormat.target, LevelGL,
+							    0, 0, 0,
+							    Extent.x, Extent.y, Extent.z,
+							    uploadFormat.externalFormat, uploadFormat.type,
+							    data
+							);
+						}
+					} break;
+					default:
+						tassert(0);
+						break;
 				}
 			}
 		}
+	}
+
+	impl::LoadTextureResult impl::loadTexture(
+	    OpenglContext& openglContext,
+	    gli::texture const& Texture, bool SRGB
+	) {
+		auto uploadFormat = translateFormat(Texture, SRGB);
+
+		if (!uploadFormat.has_value()) {
+			openglContext.logError("Unsupported texture target, only 2D, 2D array, cube and 3D textures can be loaded.\n");
+			return std::nullopt;
+		}
+
+		auto result = allocateTexture(openglContext, Texture, uploadFormat.value());
+
+		if (!result.has_value()) {
+			return std::nullopt;
+		}
+
+		for (integer_t level = 0; std::cmp_less(level, Texture.levels()); level++) {
+			uploadLevel(Texture, uploadFormat.value(), level);
+		}
 
 		return result;
 	}
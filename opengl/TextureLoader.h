@@ -2,9 +2,11 @@
 
 #include <wrangled_gl/wrangled_gl.h>
 
+#include <array>
 #include <variant>
 #include <optional>
 
+#include <tepp/integers.h>
 #include <tepp/span.h>
 
 namespace gli
@@ -16,15 +18,56 @@ namespace render::opengl
 {
 	struct Opengl2DTexture;
 	struct Opengl2DArrayTexture;
+	struct OpenglCubeTexture;
+	struct Opengl3DTexture;
 	struct OpenglContext;
 
 	Opengl2DTexture load2DTexture(OpenglContext& openglContext, te::span<char const> buffer, bool SRGB = true);
 
 	Opengl2DArrayTexture load2DArrayTexture(OpenglContext& openglContext, te::span<char const> buffer, bool SRGB = true);
 
+	OpenglCubeTexture loadCubeTexture(OpenglContext& openglContext, te::span<char const> buffer, bool SRGB = true);
+
+	Opengl3DTexture load3DTexture(OpenglContext& openglContext, te::span<char const> buffer, bool SRGB = true);
+
+	// Uploads a DDS straight from buffer without an intermediate copy of the pixel data, meant for
+	// buffers backed by MappedData.
+	std::optional<Opengl2DTexture> load2DTextureDirect(OpenglContext& openglContext, te::span<char const> buffer, bool SRGB = true);
+
 	namespace impl
 	{
-		using LoadTextureResult = std::optional<std::variant<Opengl2DTexture, Opengl2DArrayTexture>>;
+		using LoadedTexture = std::variant<Opengl2DTexture, Opengl2DArrayTexture, OpenglCubeTexture, Opengl3DTexture>;
+		using LoadTextureResult = std::optional<LoadedTexture>;
+
+		struct UploadFormat
+		{
+			GLenum target{};
+			GLenum internalFormat{};
+			GLenum externalFormat{};
+			GLenum type{};
+			std::array<GLint, 4> swizzles{};
+		};
+
+		std::optional<UploadFormat> translateFormat(gli::texture const& Texture, bool SRGB);
+
+		// Creates the texture object with immutable storage for every level, leaves it bound.
+		LoadTextureResult allocateTexture(
+		    OpenglContext& openglContext,
+		    gli::texture const& Texture,
+		    UploadFormat const& uploadFormat
+		);
+
+		// Byte size of a level summed over all layers and faces.
+		integer_t getLevelByteSize(gli::texture const& Texture, integer_t level);
+
+		// Uploads every layer and face of a single level to the currently bound texture. With fromUnpackBuffer
+		// set the data is read from the bound GL_PIXEL_UNPACK_BUFFER, which holds a copy of the storage of Texture.
+		void uploadLevel(
+		    gli::texture const& Texture,
+		    UploadFormat const& uploadFormat,
+		    integer_t level,
+		    bool fromUnpackBuffer = false
+		);
 
 		LoadTextureResult loadTexture(
 		    OpenglContext& openglContext,
@@ -4,12 +4,20 @@
 
 #include <tepp/safety_cast.h>
 
+#include <charconv>
+#include <string>
+#include <system_error>
+
 namespace render::opengl
 {
 	te::cstring_view OpenglSampler2D::getValueType() {
 		return "sampler2D";
 	}
 
+	void OpenglSampler2D::refresh() {
+		this->initialize(this->name, isize(this->units), *this->program);
+	}
+
 	void OpenglSampler2D::initialize(te::cstring_view name_, Program& program_) {
 		this->initialize(name_, 1, program_);
 	}
@@ -18,8 +26,7 @@ namespace render::opengl
 		auto refresh = this->program != nullptr;
 
 		this->program = &program_;
-		this->program->use();
-		this->location = glGetUniformLocation(this->program->ID.data, name_.getData());
+		this->lookupLocation(name_, GL_SAMPLER_2D);
 
 		if (!refresh) {
 			tassert(this->units.empty());
@@ -35,16 +42,20 @@ namespace render::opengl
 
 		tassert(isize(this->units) == count);
 
+		this->markDirty();
+	}
+
+	void OpenglSampler2D::upload() {
 		this->program->openglContext.tallyUniformBytesTransferred(te::span(this->units).size_bytes());
-		glUniform1iv(this->location, static_cast<GLsizei>(count), units.data());
+		glUniform1iv(this->location, static_cast<GLsizei>(this->units.size()), this->units.data());
 	}
 
 	void OpenglSampler2D::set(Opengl2DTexture const& texture) {
 		tassert(this->program);
 		tassert(!this->units.empty());
 
-		this->program->use();
 		this->program->openglContext.bind(texture, this->units.front());
+		this->program->openglContext.unbindSampler(this->units.front());
 	}
 
 	void OpenglSampler2D::set(Opengl2DTexture const& texture, integer_t index) {
@@ -55,8 +66,8 @@ namespace render::opengl
 
 		tassert(this->program);
 
-		this->program->use();
 		this->program->openglContext.bind(texture, this->units[index]);
+		this->program->openglContext.unbindSampler(this->units[index]);
 	}
 
 	void OpenglSampler2D::set(Qualified<GLuint> ID, integer_t index) {
@@ -67,22 +78,41 @@ namespace render::opengl
 
 		tassert(this->program);
 
-		this->program->use();
 		this->program->openglContext.bind(ID, TextureTarget::Type::TEXTURE_2D, this->units[index]);
+		this->program->openglContext.unbindSampler(this->units[index]);
+	}
+
+	void OpenglSampler2D::set(Opengl2DTexture const& texture, OpenglSamplerObject const& sampler) {
+		tassert(!this->units.empty());
+
+		this->set(texture, sampler, 0);
+	}
+
+	void OpenglSampler2D::set(Opengl2DTexture const& texture, OpenglSamplerObject const& sampler, integer_t index) {
+		if (!(0 <= index && index < isize(this->units))) {
+			tassert(0);
+			return;
+		}
+
+		tassert(this->program);
+
+		this->program->openglContext.bind(texture, this->units[index]);
+		this->program->openglContext.bind(sampler, this->units[index]);
 	}
 
 	te::cstring_view OpenglSampler3D::getValueType() {
 		return "sampler3D";
 	}
 
+	void OpenglSampler3D::refresh() {
+		this->initialize(this->name, *this->program);
+	}
+
 	void OpenglSampler3D::initialize(te::cstring_view name_, Program& program_) {
 		auto refresh = this->program != nullptr;
 
 		this->program = &program_;
-		this->location = glGetUniformLocation(this->program->ID.data, name_.getData());
-		this->unit = this->program->getNextSampler();
-
-		this->program->use();
+		this->lookupLocation(name_, GL_SAMPLER_3D);
 
 		if (!refresh) {
 			this->name = name_;
@@ -93,6 +123,10 @@ namespace render::opengl
 			tassert(this->name == name_);
 		}
 
+		this->markDirty();
+	}
+
+	void OpenglSampler3D::upload() {
 		this->program->openglContext.tallyUniformBytesTransferred(sizeof(this->unit));
 		glUniform1i(this->location, this->unit);
 	}
@@ -100,21 +134,82 @@ namespace render::opengl
 	void OpenglSampler3D::set(Opengl2DArrayTexture const& texture) {
 		tassert(this->program);
 
-		this->program->use();
 		this->program->openglContext.bind(texture, this->unit);
+		this->program->openglContext.unbindSampler(this->unit);
+	}
+
+	void OpenglSampler3D::set(Opengl3DTexture const& texture) {
+		tassert(this->program);
+
+		this->program->openglContext.bind(texture, this->unit);
+		this->program->openglContext.unbindSampler(this->unit);
+	}
+
+	void OpenglSampler3D::set(Opengl3DTexture const& texture, OpenglSamplerObject const& sampler) {
+		tassert(this->program);
+
+		this->program->openglContext.bind(texture, this->unit);
+		this->program->openglContext.bind(sampler, this->unit);
+	}
+
+	te::cstring_view OpenglSamplerCube::getValueType() {
+		return "samplerCube";
+	}
+
+	void OpenglSamplerCube::refresh() {
+		this->initialize(this->name, *this->program);
+	}
+
+	void OpenglSamplerCube::initialize(te::cstring_view name_, Program& program_) {
+		auto refresh = this->program != nullptr;
+
+		this->program = &program_;
+		this->lookupLocation(name_, GL_SAMPLER_CUBE);
+
+		if (!refresh) {
+			this->name = name_;
+			this->program->registerUniform(*this);
+			this->unit = this->program->getNextSampler();
+		}
+		else {
+			tassert(this->name == name_);
+		}
+
+		this->markDirty();
+	}
+
+	void OpenglSamplerCube::upload() {
+		this->program->openglContext.tallyUniformBytesTransferred(sizeof(this->unit));
+		glUniform1i(this->location, this->unit);
+	}
+
+	void OpenglSamplerCube::set(OpenglCubeTexture const& texture) {
+		tassert(this->program);
+
+		this->program->openglContext.bind(texture, this->unit);
+		this->program->openglContext.unbindSampler(this->unit);
+	}
+
+	void OpenglSamplerCube::set(OpenglCubeTexture const& texture, OpenglSamplerObject const& sampler) {
+		tassert(this->program);
+
+		this->program->openglContext.bind(texture, this->unit);
+		this->program->openglContext.bind(sampler, this->unit);
 	}
 
 	te::cstring_view OpenglSamplerBufferTexture::getValueType() {
 		return "buffer texture";
 	}
 
+	void OpenglSamplerBufferTexture::refresh() {
+		this->initialize(this->name, *this->program);
+	}
+
 	void OpenglSamplerBufferTexture::initialize(te::cstring_view name_, Program& program_) {
 		auto refresh = this->program != nullptr;
 
 		this->program = &program_;
-		this->location = glGetUniformLocation(this->program->ID.data, name_.getData());
-
-		this->program->use();
+		this->lookupLocation(name_, GL_SAMPLER_BUFFER);
 
 		if (!refresh) {
 			this->name = name_;
@@ -125,6 +220,10 @@ namespace render::opengl
 			tassert(this->name == name_);
 		}
 
+		this->markDirty();
+	}
+
+	void OpenglSamplerBufferTexture::upload() {
 		this->program->openglContext.tallyUniformBytesTransferred(sizeof(this->unit));
 		glUniform1i(this->location, this->unit);
 	}
@@ -132,11 +231,74 @@ namespace render::opengl
 	void OpenglSamplerBufferTexture::set(OpenglBufferTexture const& texture) {
 		tassert(this->program);
 
-		this->program->use();
 		this->program->openglContext.bind(texture, this->unit);
 	}
 
 	te::cstring_view UniformBase::getName() const {
 		return this->name;
 	}
+
+	namespace
+	{
+		bool isCompatible(GLenum declared, GLenum type) {
+			if (declared == type) {
+				return true;
+			}
+
+			if (isSamplerType(declared)) {
+				return isSamplerType(type);
+			}
+
+			if (declared == GL_INT) {
+				return type == GL_BOOL || isSamplerType(type);
+			}
+
+			return false;
+		}
+	}
+
+	void UniformBase::markDirty() {
+		this->program->markDirty(*this);
+	}
+
+	void UniformBase::lookupLocation(std::string_view name_, GLenum type) {
+		auto info = this->program->reflection.findUniform(name_);
+		this->location = static_cast<GLuint>(-1);
+
+		if (info != nullptr) {
+			this->location = static_cast<GLuint>(info->location);
+		}
+		else if (auto bracket = name_.rfind('['); bracket != std::string_view::npos && name_.ends_with(']')) {
+			// Element of an array uniform, reflection only holds the array itself.
+			auto indexString = name_.substr(bracket + 1, name_.size() - bracket - 2);
+			integer_t index = -1;
+			auto [end, error] = std::from_chars(indexString.data(), indexString.data() + indexString.size(), index);
+
+			if (error != std::errc() || end != indexString.data() + indexString.size()) {
+				this->program->openglContext.logWarning("Uniform {} has a malformed array index.\n", name_);
+				return;
+			}
+
+			info = this->program->reflection.findUniform(name_.substr(0, bracket));
+
+			if (info == nullptr) {
+				return;
+			}
+
+			if (!(0 <= index && index < info->size)) {
+				this->program->openglContext.logWarning("Uniform {} is out of bounds, the array has {} elements.\n", name_, info->size);
+				return;
+			}
+
+			// Element locations are only consecutive for explicit locations, so ask for this one.
+			this->location = static_cast<GLuint>(glGetUniformLocation(this->program->ID.data, std::string(name_).c_str()));
+		}
+		else {
+			return;
+		}
+
+		if (!isCompatible(type, info->type)) {
+			this->program->openglContext.logWarning("Uniform {} is set as {} but declared with GL type {:#x}.\n", name_, this->getValueType().getData(), info->type);
+		}
+	}
 }
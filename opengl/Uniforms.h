@@ -1,9 +1,12 @@
 #pragma once
 
 #include <algorithm>
-#include <variant>
+#include <cstring>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
+#include <wglm/glm.hpp>
 #include <wglm/mat4x4.hpp>
 #include <wglm/vec2.hpp>
 #include <wglm/vec3.hpp>
@@ -14,11 +17,11 @@
 
 #include <tepp/cstring_view.h>
 #include <tepp/span.h>
-#include <tepp/variant.h>
 
 #include <wrangled_gl/wrangled_gl.h>
 
 #include "render/Convert.h"
+#include "render/DataType.h"
 
 namespace render::opengl
 {
@@ -27,6 +30,9 @@ namespace render::opengl
 
 	struct Opengl2DTexture;
 	struct Opengl2DArrayTexture;
+	struct OpenglCubeTexture;
+	struct Opengl3DTexture;
+	struct OpenglSamplerObject;
 	struct OpenglBufferTexture;
 
 	struct UniformBase
@@ -37,181 +43,195 @@ namespace render::opengl
 
 		virtual te::cstring_view getValueType() = 0;
 		te::cstring_view getName() const;
-	};
 
-	template<>
-	struct SetUniform<float>
-	{
-		static te::cstring_view name() {
-			return "float";
-		}
+		// Sets location from the reflection of program, warns when the declared type does not match.
+		void lookupLocation(std::string_view name, GLenum type);
 
-		static void apply(GLuint location, te::span<float const> values) {
-			glUniform1fv(location, auto_safety(values.size()), values.data());
-		}
-	};
+		// Called after the program is relinked, locations may have changed.
+		virtual void refresh() = 0;
 
-	template<>
-	struct SetUniform<glm::ivec2>
-	{
-		static te::cstring_view name() {
-			return "ivec2";
-		}
+		// Position in Program::getUniformsSorted, indexes the dirty bits of the program.
+		integer_t sortedIndex = -1;
+		bool dirty = false;
 
-		static void apply(GLuint location, te::span<glm::ivec2 const> values) {
-			glUniform2iv(location, auto_safety(values.size()), &values[0][0]);
-		}
-	};
+		// Writes the stored value, called from Program::flushUniforms while the program is in use.
+		virtual void upload() = 0;
 
-	template<>
-	struct SetUniform<glm::vec2>
-	{
-		static te::cstring_view name() {
-			return "vec2";
-		}
-
-		static void apply(GLuint location, te::span<glm::vec2 const> values) {
-			glUniform2fv(location, auto_safety(values.size()), &values[0][0]);
-		}
+		void markDirty();
 	};
 
-	template<>
-	struct SetUniform<glm::vec3>
-	{
-		static te::cstring_view name() {
-			return "vec3";
-		}
-
-		static void apply(GLuint location, te::span<glm::vec3 const> values) {
-			glUniform3fv(location, auto_safety(values.size()), &values[0][0]);
-		}
+	// TYPE, DATA_TYPE, GL_TYPE, NAME, ELEMENT, FUNCTION
+#define UNIFORM_VECTOR_LIST(X) \
+	X(float, f32, GL_FLOAT, "float", GLfloat, glUniform1fv) \
+	X(glm::vec2, vec2, GL_FLOAT_VEC2, "vec2", GLfloat, glUniform2fv) \
+	X(glm::vec3, vec3, GL_FLOAT_VEC3, "vec3", GLfloat, glUniform3fv) \
+	X(glm::vec4, vec4, GL_FLOAT_VEC4, "vec4", GLfloat, glUniform4fv) \
+	X(int32_t, i32, GL_INT, "int", GLint, glUniform1iv) \
+	X(glm::ivec2, ivec2, GL_INT_VEC2, "ivec2", GLint, glUniform2iv) \
+	X(glm::ivec3, ivec3, GL_INT_VEC3, "ivec3", GLint, glUniform3iv) \
+	X(glm::ivec4, ivec4, GL_INT_VEC4, "ivec4", GLint, glUniform4iv) \
+	X(uint32_t, u32, GL_UNSIGNED_INT, "uint", GLuint, glUniform1uiv) \
+	X(glm::uvec2, uvec2, GL_UNSIGNED_INT_VEC2, "uvec2", GLuint, glUniform2uiv) \
+	X(glm::uvec3, uvec3, GL_UNSIGNED_INT_VEC3, "uvec3", GLuint, glUniform3uiv) \
+	X(glm::uvec4, uvec4, GL_UNSIGNED_INT_VEC4, "uvec4", GLuint, glUniform4uiv)
+
+#define UNIFORM_MATRIX_LIST(X) \
+	X(glm::mat2, mat2, GL_FLOAT_MAT2, "mat2", GLfloat, glUniformMatrix2fv) \
+	X(glm::mat3, mat3, GL_FLOAT_MAT3, "mat3", GLfloat, glUniformMatrix3fv) \
+	X(glm::mat4, mat4, GL_FLOAT_MAT4, "mat4", GLfloat, glUniformMatrix4fv) \
+	X(glm::mat2x3, mat2x3, GL_FLOAT_MAT2x3, "mat2x3", GLfloat, glUniformMatrix2x3fv) \
+	X(glm::mat3x2, mat3x2, GL_FLOAT_MAT3x2, "mat3x2", GLfloat, glUniformMatrix3x2fv) \
+	X(glm::mat2x4, mat2x4, GL_FLOAT_MAT2x4, "mat2x4", GLfloat, glUniformMatrix2x4fv) \
+	X(glm::mat4x2, mat4x2, GL_FLOAT_MAT4x2, "mat4x2", GLfloat, glUniformMatrix4x2fv) \
+	X(glm::mat3x4, mat3x4, GL_FLOAT_MAT3x4, "mat3x4", GLfloat, glUniformMatrix3x4fv) \
+	X(glm::mat4x3, mat4x3, GL_FLOAT_MAT4x3, "mat4x3", GLfloat, glUniformMatrix4x3fv)
+
+#define SET_UNIFORM_COMMON(TYPE, DATA_TYPE, GL_TYPE, NAME) \
+	static constexpr DataType dataType = DataType::DATA_TYPE; \
+	static constexpr GLenum type = GL_TYPE; \
+	static constexpr integer_t byteSize = sizeof(TYPE); \
+	static_assert(byteSize == dataTypeByteSize[dataType]); \
+\
+	static te::cstring_view name() { \
+		return NAME; \
+	}
+
+#define DEFINE_SET_UNIFORM_VECTOR(TYPE, DATA_TYPE, GL_TYPE, NAME, ELEMENT, FUNCTION) \
+	template<> \
+	struct SetUniform<TYPE> \
+	{ \
+		SET_UNIFORM_COMMON(TYPE, DATA_TYPE, GL_TYPE, NAME) \
+\
+		static void apply(GLuint location, te::span<TYPE const> values) { \
+			FUNCTION(location, auto_safety(values.size()), reinterpret_cast<ELEMENT const*>(values.data())); \
+		} \
 	};
 
-	template<>
-	struct SetUniform<glm::vec4>
-	{
-		static te::cstring_view name() {
-			return "vec4";
-		}
-
-		static void apply(GLuint location, te::span<glm::vec4 const> values) {
-			glUniform4fv(location, auto_safety(values.size()), &values[0][0]);
-		}
+#define DEFINE_SET_UNIFORM_MATRIX(TYPE, DATA_TYPE, GL_TYPE, NAME, ELEMENT, FUNCTION) \
+	template<> \
+	struct SetUniform<TYPE> \
+	{ \
+		SET_UNIFORM_COMMON(TYPE, DATA_TYPE, GL_TYPE, NAME) \
+\
+		static void apply(GLuint location, te::span<TYPE const> values) { \
+			FUNCTION(location, auto_safety(values.size()), GL_FALSE, reinterpret_cast<ELEMENT const*>(values.data())); \
+		} \
 	};
 
-	template<>
-	struct SetUniform<glm::mat4>
-	{
-		static te::cstring_view name() {
-			return "mat4";
-		}
+	UNIFORM_VECTOR_LIST(DEFINE_SET_UNIFORM_VECTOR)
+	UNIFORM_MATRIX_LIST(DEFINE_SET_UNIFORM_MATRIX)
 
-		static void apply(GLuint location, te::span<glm::mat4 const> values) {
-			glUniformMatrix4fv(location, auto_safety(values.size()), GL_FALSE, &values[0][0][0]);
-		}
-	};
+#undef DEFINE_SET_UNIFORM_MATRIX
+#undef DEFINE_SET_UNIFORM_VECTOR
+#undef SET_UNIFORM_COMMON
+#undef UNIFORM_MATRIX_LIST
+#undef UNIFORM_VECTOR_LIST
 
+	// GLSL bools have no DataType, they are converted and set through the integer entry point.
 	template<>
-	struct SetUniform<int32_t>
+	struct SetUniform<bool>
 	{
+		static constexpr GLenum type = GL_BOOL;
+		static constexpr integer_t byteSize = sizeof(GLint);
+
 		static te::cstring_view name() {
-			return "int32";
+			return "bool";
 		}
 
-		static void apply(GLuint location, te::span<int32_t const> values) {
-			glUniform1iv(location, auto_safety(values.size()), &values[0]);
+		static void apply(GLuint location, te::span<bool const> values) {
+			static thread_local std::vector<GLint> buffer{};
+			buffer.assign(values.begin(), values.end());
+
+			glUniform1iv(location, static_cast<GLsizei>(buffer.size()), buffer.data());
 		}
 	};
 
 	template<class T>
 	struct Uniform : UniformBase
 	{
-		std::optional<std::variant<T, std::vector<T>>> current{};
+		static_assert(std::is_trivially_copyable_v<T>);
+
+		// Sized from the reflected array size on initialize, only grows when a longer span is set.
+		std::unique_ptr<T[]> values{};
+		integer_t capacity = 0;
+		integer_t count = 0;
 
 		te::cstring_view getValueType() override {
 			return SetUniform<T>::name();
 		}
 
+		void refresh() override {
+			this->initialize(this->name, *this->program);
+		}
+
+		void upload() override {
+			tassert(this->count > 0);
+
+			auto current = te::span<T const>(this->values.get(), static_cast<std::size_t>(this->count));
+
+			this->program->openglContext.tallyUniformBytesTransferred(current.size_bytes());
+			SetUniform<T>::apply(this->location, current);
+		}
+
 		Uniform() = default;
 		void initialize(te::cstring_view name_, Program& program_) {
 			auto refresh = this->program != nullptr;
 
 			this->program = &program_;
-			this->program->use();
-			this->location = glGetUniformLocation(this->program->ID.data, name_.getData());
+			this->lookupLocation(name_, SetUniform<T>::type);
+
+			if (auto info = this->program->reflection.findUniform(name_)) {
+				this->reserve(info->size);
+			}
+
 			if (refresh) {
 				tassert(this->name == name_);
-				if (this->current.has_value()) {
-					te::visit(this->current.value(), [&](auto& v) {
-						this->set(v, true);
-					});
+				if (this->count > 0) {
+					this->markDirty();
 				}
 			}
 			else {
 				this->name = name_;
 				this->program->registerUniform(*this);
-				this->current.reset();
+				this->count = 0;
 			}
 		}
-		DEFAULT_COPY_MOVE(Uniform);
+		DEFAULT_MOVE(Uniform);
+		NO_COPY(Uniform);
 		~Uniform() = default;
 
-		void set(te::span<T const> values, bool force = false) {
-			tassert(this->program);
-
-			if (!force && this->current.has_value()) {
-				tassert(std::holds_alternative<std::vector<T>>(this->current.value()));
-
-				auto done = te::visit(
-				    this->current.value(),
-				    [&](std::vector<T>& vec) {
-					    if (std::ranges::equal(values, vec)) {
-						    return true;
-					    }
-
-					    std::ranges::copy(values, vec.begin());
-
-					    return false;
-				    },
-				    [](auto&) {
-					    return false;
-				    }
-				);
-
-				if (done) {
-					return;
-				}
+		void reserve(integer_t size) {
+			if (size > this->capacity) {
+				auto newValues = std::make_unique<T[]>(static_cast<std::size_t>(size));
+				std::copy_n(this->values.get(), this->count, newValues.get());
+				this->values = std::move(newValues);
+				this->capacity = size;
 			}
-
-			this->program->use();
-
-			this->program->openglContext.tallyUniformBytesTransferred(values.size_bytes());
-			SetUniform<T>::apply(this->location, values);
-			auto c = std::vector<T>();
-			c.resize(values.size());
-			std::ranges::copy(values, c.begin());
-			this->current = std::move(c);
 		}
 
-		void set(T const& value, bool force = false) {
+		void set(te::span<T const> newValues, bool force = false) {
 			tassert(this->program);
 
-			if (!force && this->current.has_value()) {
-				tassert(std::holds_alternative<T>(this->current.value()));
+			if (newValues.empty()) {
+				return;
+			}
 
-				if (auto currentValue = std::get_if<T>(&this->current.value())) {
-					if (*currentValue == value) {
-						return;
-					}
-				}
+			if (!force
+			    && this->count == isize(newValues)
+			    && std::memcmp(this->values.get(), newValues.data(), newValues.size_bytes()) == 0) {
+				return;
 			}
 
-			this->current = value;
+			this->reserve(isize(newValues));
+
+			std::memcpy(this->values.get(), newValues.data(), newValues.size_bytes());
+			this->count = isize(newValues);
 
-			this->program->use();
+			this->markDirty();
+		}
 
-			this->program->openglContext.tallyUniformBytesTransferred(sizeof(T));
-			SetUniform<T>::apply(this->location, te::span(&value, 1_i));
+		void set(T const& value, bool force = false) {
+			this->set(te::span(&value, 1_i), force);
 		}
 	};
 
@@ -220,6 +240,8 @@ namespace render::opengl
 		std::vector<GLint> units{};
 
 		te::cstring_view getValueType() override;
+		void refresh() override;
+		void upload() override;
 
 		OpenglSampler2D() = default;
 		void initialize(te::cstring_view name, Program& program);
@@ -231,6 +253,8 @@ namespace render::opengl
 		void set(Opengl2DTexture const& texture);
 		void set(Opengl2DTexture const& texture, integer_t index);
 		void set(Qualified<GLuint> ID, integer_t index);
+		void set(Opengl2DTexture const& texture, OpenglSamplerObject const& sampler);
+		void set(Opengl2DTexture const& texture, OpenglSamplerObject const& sampler, integer_t index);
 	};
 
 	struct OpenglSampler3D : UniformBase
@@ -238,6 +262,8 @@ namespace render::opengl
 		int32_t unit{};
 
 		te::cstring_view getValueType() override;
+		void refresh() override;
+		void upload() override;
 
 		OpenglSampler3D() = default;
 		void initialize(te::cstring_view name, Program& program);
@@ -246,6 +272,26 @@ namespace render::opengl
 		~OpenglSampler3D() = default;
 
 		void set(Opengl2DArrayTexture const& texture);
+		void set(Opengl3DTexture const& texture);
+		void set(Opengl3DTexture const& texture, OpenglSamplerObject const& sampler);
+	};
+
+	struct OpenglSamplerCube : UniformBase
+	{
+		int32_t unit{};
+
+		te::cstring_view getValueType() override;
+		void refresh() override;
+		void upload() override;
+
+		OpenglSamplerCube() = default;
+		void initialize(te::cstring_view name, Program& program);
+		DEFAULT_MOVE(OpenglSamplerCube);
+		NO_COPY(OpenglSamplerCube);
+		~OpenglSamplerCube() = default;
+
+		void set(OpenglCubeTexture const& texture);
+		void set(OpenglCubeTexture const& texture, OpenglSamplerObject const& sampler);
 	};
 
 	struct OpenglSamplerBufferTexture : UniformBase
@@ -253,6 +299,8 @@ namespace render::opengl
 		int32_t unit{};
 
 		te::cstring_view getValueType() override;
+		void refresh() override;
+		void upload() override;
 
 		OpenglSamplerBufferTexture() = default;
 		void initialize(te::cstring_view name, Program& program);
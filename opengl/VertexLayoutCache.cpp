@@ -0,0 +1,175 @@
+#include "render/opengl/VertexLayoutCache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "render/Hash.h"
+#include "render/opengl/OpenglContext.h"
+#include "render/opengl/OpenglVBO.h"
+
+namespace render::opengl
+{
+	namespace
+	{
+		bool supportsSeparateFormat(OpenglContext const& openglContext) {
+			auto version = std::pair(openglContext.majorVersion, openglContext.minorVersion);
+
+			if (openglContext.isES()) {
+				return version >= std::pair(3, 1);
+			}
+
+			return version >= std::pair(4, 3) || openglContext.hasExtension("GL_ARB_vertex_attrib_binding");
+		}
+
+		// Attribute formats belong to the binding, so every attribute of a buffer has to step at the same rate.
+		bool hasBindingDivisors(VertexLayout const& layout) {
+			return std::ranges::all_of(layout.buffers, [](auto const& buffer) {
+				return std::ranges::all_of(buffer.attributes, [&](auto const& attribute) {
+					return attribute.divisor == buffer.divisor;
+				});
+			});
+		}
+
+		void setAttributeFormats(GLuint index, GLuint binding, VertexBufferLayout const& buffer) {
+			for (auto const& attribute : buffer.attributes) {
+				auto format = getAttributeFormat(attribute.dataType);
+
+				if (!format.has_value()) {
+					tassert(0);
+					continue;
+				}
+
+				for (integer_t column = 0; column < format->columns; column++, index++) {
+					auto offset = static_cast<GLuint>(attribute.offset + column * format->columnStride);
+
+					if (format->integer) {
+						glVertexAttribIFormat(index, format->size, format->type, offset);
+					}
+					else {
+						glVertexAttribFormat(index, format->size, format->type, format->normalized, offset);
+					}
+					glVertexAttribBinding(index, binding);
+					glEnableVertexAttribArray(index);
+				}
+			}
+
+			glVertexBindingDivisor(binding, buffer.divisor);
+		}
+
+		GLuint getAttributeCount(VertexBufferLayout const& buffer) {
+			GLuint count = 0;
+			for (auto const& attribute : buffer.attributes) {
+				if (auto format = getAttributeFormat(attribute.dataType)) {
+					count += static_cast<GLuint>(format->columns);
+				}
+			}
+			return count;
+		}
+	}
+
+	VertexLayout& VertexLayout::add(Descriptor const& descriptor) {
+		this->buffers.push_back(
+		    VertexBufferLayout{
+		        .attributes = descriptor.attributes,
+		        .stride = descriptor.stride,
+		        .divisor = descriptor.getDivisor(),
+		    }
+		);
+
+		return *this;
+	}
+
+	std::size_t VertexLayout::Hasher::operator()(VertexLayout const& layout) const {
+		std::vector<int64_t> values{};
+
+		for (auto const& buffer : layout.buffers) {
+			values.push_back(buffer.stride);
+			values.push_back(buffer.divisor);
+			values.push_back(isize(buffer.attributes));
+
+			for (auto const& attribute : buffer.attributes) {
+				values.push_back(static_cast<int64_t>(attribute.dataType));
+				values.push_back(attribute.offset);
+				values.push_back(attribute.divisor);
+			}
+		}
+
+		return static_cast<std::size_t>(hashBytes(te::as_bytes(te::span(values))));
+	}
+
+	void SharedVertexArray::bind(te::span<OpenglVBO* const> buffers, OpenglVBO* indices) {
+		tassert(buffers.size() == this->layout.buffers.size());
+
+		this->VAO.bind();
+
+		for (std::size_t binding = 0; binding < buffers.size(); binding++) {
+			auto& buffer = *buffers[binding];
+
+			if (this->boundBuffers[binding] == buffer.ID) {
+				continue;
+			}
+
+			if (this->separateFormat) {
+				glBindVertexBuffer(static_cast<GLuint>(binding), buffer.ID.data, 0, this->layout.buffers[binding].stride);
+			}
+			else {
+				buffer.bind(BufferTarget::Type::ARRAY_BUFFER);
+
+				auto index = this->firstAttributes[binding];
+				for (auto const& attribute : this->layout.buffers[binding].attributes) {
+					index = setAttributePointer(index, attribute, this->layout.buffers[binding].stride);
+				}
+			}
+
+			this->boundBuffers[binding] = buffer.ID;
+		}
+
+		if (indices != nullptr && this->boundIndices != indices->ID) {
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices->ID.data);
+			this->VAO.openglContext->boundBuffers[BufferTarget::Type::ELEMENT_ARRAY_BUFFER] = indices->ID;
+			this->boundIndices = indices->ID;
+		}
+	}
+
+	SharedVertexArray::SharedVertexArray(OpenglContext& openglContext, VertexLayout layout_, bool separateFormat_)
+	    : VAO(openglContext),
+	      layout(std::move(layout_)),
+	      separateFormat(separateFormat_ && hasBindingDivisors(this->layout)) {
+		this->boundBuffers.resize(this->layout.buffers.size());
+
+		GLuint index = 0;
+		for (auto const& buffer : this->layout.buffers) {
+			this->firstAttributes.push_back(index);
+			index += getAttributeCount(buffer);
+		}
+
+		this->VAO.attributeCount = static_cast<GLint>(index);
+
+		if (this->separateFormat) {
+			this->VAO.bind();
+
+			for (std::size_t binding = 0; binding < this->layout.buffers.size(); binding++) {
+				setAttributeFormats(this->firstAttributes[binding], static_cast<GLuint>(binding), this->layout.buffers[binding]);
+			}
+		}
+	}
+
+	SharedVertexArray& VertexLayoutCache::get(VertexLayout const& layout) {
+		auto it = this->arrays.find(layout);
+
+		if (it == this->arrays.end()) {
+			it = this->arrays.emplace(layout, std::make_unique<SharedVertexArray>(this->openglContext, layout, this->separateFormat)).first;
+		}
+
+		return *it->second;
+	}
+
+	void VertexLayoutCache::clear() {
+		this->arrays.clear();
+	}
+
+	VertexLayoutCache::VertexLayoutCache(OpenglContext& openglContext_)
+	    : openglContext(openglContext_),
+	      separateFormat(supportsSeparateFormat(openglContext_)) {
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <misc/Misc.h>
+
+#include <tepp/integers.h>
+#include <tepp/span.h>
+
+#include <wrangled_gl/wrangled_gl.h>
+
+#include "render/opengl/OpenglVAO.h"
+#include "render/opengl/Qualifier.h"
+
+namespace render::opengl
+{
+	struct OpenglContext;
+	struct OpenglVBO;
+
+	// Attributes read from one vertex buffer binding.
+	struct VertexBufferLayout
+	{
+		std::vector<VertexAttribute> attributes{};
+		GLsizei stride{};
+		GLuint divisor{};
+
+		bool operator==(VertexBufferLayout const& other) const = default;
+	};
+
+	struct VertexLayout
+	{
+		std::vector<VertexBufferLayout> buffers{};
+
+		// Appends the attributes of descriptor as the next buffer binding, attribute indices follow in order.
+		VertexLayout& add(Descriptor const& descriptor);
+
+		bool operator==(VertexLayout const& other) const = default;
+
+		struct Hasher
+		{
+			std::size_t operator()(VertexLayout const& layout) const;
+		};
+	};
+
+	// A VAO shared by everything drawn with the same layout. With separate attribute formats
+	// (GL 4.3, ES 3.1 or ARB_vertex_attrib_binding) the formats are set once and bind() only swaps
+	// the buffers of the bindings that changed. Otherwise the attribute pointers of changed
+	// bindings are specified again, which still saves the VAO switch.
+	struct SharedVertexArray
+	{
+		OpenglVAO VAO;
+		VertexLayout layout{};
+		bool separateFormat = false;
+
+		std::vector<GLuint> firstAttributes{};
+		std::vector<Qualified<GLuint>> boundBuffers{};
+		Qualified<GLuint> boundIndices{};
+
+		// buffers holds one buffer per binding of layout.
+		void bind(te::span<OpenglVBO* const> buffers, OpenglVBO* indices = nullptr);
+
+		SharedVertexArray(OpenglContext& openglContext, VertexLayout layout, bool separateFormat);
+		~SharedVertexArray() = default;
+
+		NO_COPY_MOVE(SharedVertexArray);
+	};
+
+	struct VertexLayoutCache
+	{
+		OpenglContext& openglContext;
+		bool separateFormat = false;
+
+		std::unordered_map<VertexLayout, std::unique_ptr<SharedVertexArray>, VertexLayout::Hasher> arrays{};
+
+		SharedVertexArray& get(VertexLayout const& layout);
+		void clear();
+
+		VertexLayoutCache(OpenglContext& openglContext);
+		~VertexLayoutCache() = default;
+
+		NO_COPY_MOVE(VertexLayoutCache);
+	};
+}